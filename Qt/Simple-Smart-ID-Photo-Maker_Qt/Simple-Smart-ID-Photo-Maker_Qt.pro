@@ -1,4 +1,4 @@
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -8,6 +8,11 @@ CONFIG += c++17
 unix {
     CONFIG += link_pkgconfig
     PKGCONFIG += opencv4
+
+    # 공유 메모리 프레임 링 입력(shm_open)
+    SOURCES += shmringframesource.cpp
+    HEADERS += shmframering.h shmringframesource.h
+    !macx: LIBS += -lrt
 }
 
 win32 {
@@ -27,18 +32,48 @@ win32 {
 
 SOURCES += \
     aspectratiolabel.cpp \
+    composetask.cpp \
     export_page.cpp \
+    faceanalysis.cpp \
+    facetracker.cpp \
+    framecontext.cpp \
+    framegrabber.cpp \
+    framesource.cpp \
+    graphcutsegmenter.cpp \
+    lbfmodel.cpp \
+    guidedfilter.cpp \
     main.cpp \
     main_app.cpp \
+    modelregistry.cpp \
     photoeditpage.cpp \
+    pipelinebench.cpp \
+    previewscheduler.cpp \
+    startuptrace.cpp \
     suitcomposer.cpp
 
 HEADERS += \
+    alphaover.h \
     aspectratiolabel.h \
+    backgroundcolor.h \
+    composetask.h \
     export_page.h \
+    faceanalysis.h \
+    facetracker.h \
+    framecontext.h \
+    framegrabber.h \
+    flowgraph.h \
+    framesource.h \
+    graphcutsegmenter.h \
+    guidedfilter.h \
+    lbfmodel.h \
     main_app.h \
+    modelregistry.h \
     photoeditpage.h \
-    suitcomposer.h
+    pipelinebench.h \
+    previewscheduler.h \
+    startuptrace.h \
+    suitcomposer.h \
+    triplebuffer.h
 
 FORMS += \
     export_page.ui \
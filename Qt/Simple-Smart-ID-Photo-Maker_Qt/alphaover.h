@@ -0,0 +1,108 @@
+#ifndef ALPHAOVER_H
+#define ALPHAOVER_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+
+/*
+ * 비프리멀티플라이 RGBA 오버 연산 out = fg ⊕ bg (정수 고정소수점, 행 병렬 한 패스)
+ * - Qt 의존 없음: 앱(SuitComposer)과 콘솔 도구(webcam_to_suit)가 함께 사용
+ *     wb = Ab*(255-Af), D = Af*255 + wb (= A_out*255²), N = Cf*Af*255 + Cb*wb
+ *     A_out = round(D/255), C_out = round(N / (255*A_out)) (A_out = 0이면 0)
+ * - 나눗셈 없음: A_out별 역수 표 floor(2^32 / (255*A))를 곱하고 32비트 시프트
+ * - D 대신 255*A_out으로 나누므로 A_out이 작을수록 색 오차가 큼(A_out >= 128에서 1 LSB, 32 미만에서 최대 6 LSB)
+ *   단색 배경에 평탄화한 뒤의 오차는 정확한 나눗셈과 같은 수준(1.5 이하)
+ */
+namespace alphaover
+{
+inline const std::uint32_t *reciprocals()
+{
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> t{};
+        for (unsigned a = 1; a < 256; ++a)
+            t[a] = std::uint32_t((std::uint64_t(1) << 32) / (255u * a));
+        return t;
+    }();
+    return table.data();
+}
+
+/* 한 행(8UC4 n픽셀): 16픽셀 단위 SIMD + 나머지 스칼라, 같은 수식 */
+inline void overRow(const uchar *fg, const uchar *bg, uchar *out, int n)
+{
+    const std::uint32_t *rcp = reciprocals();
+    int x = 0;
+#if CV_SIMD128
+    const cv::v_uint16x8 v255 = cv::v_setall_u16(255), v128 = cv::v_setall_u16(128);
+    const cv::v_uint64x2 vhalf = cv::v_setall_u64(std::uint64_t(1) << 31);
+    // 4픽셀 N * 역수 → 반올림 시프트
+    auto divide = [&](const cv::v_uint32x4 &num, const cv::v_uint32x4 &r) {
+        cv::v_uint64x2 lo, hi;
+        cv::v_mul_expand(num, r, lo, hi);
+        return cv::v_pack((lo + vhalf) >> 32, (hi + vhalf) >> 32);
+    };
+    // 8픽셀: 16비트 알파/컬러 → 16비트 결과
+    auto blend8 = [&](const cv::v_uint16x8 &af, const cv::v_uint16x8 &ab, const cv::v_uint16x8 *cf, const cv::v_uint16x8 *cb, cv::v_uint16x8 *co, cv::v_uint16x8 &ao) {
+        const cv::v_uint16x8 wb = cv::v_mul_wrap(ab, v255 - af); // <= 65025
+        const cv::v_uint16x8 d = cv::v_mul_wrap(af, v255) + wb;   // <= 65025
+        const cv::v_uint16x8 t = d + v128;
+        ao = (t + (t >> 8)) >> 8; // round(D/255)
+        cv::v_uint32x4 a0, a1;
+        cv::v_expand(ao, a0, a1);
+        const cv::v_uint32x4 r0 = cv::v_lut(rcp, cv::v_reinterpret_as_s32(a0)), r1 = cv::v_lut(rcp, cv::v_reinterpret_as_s32(a1));
+        for (int c = 0; c < 3; ++c)
+        {
+            cv::v_uint32x4 p0, p1, q0, q1;
+            cv::v_mul_expand(cv::v_mul_wrap(cf[c], af), v255, p0, p1); // Cf*Af*255
+            cv::v_mul_expand(cb[c], wb, q0, q1);                       // Cb*wb
+            co[c] = cv::v_pack(divide(p0 + q0, r0), divide(p1 + q1, r1));
+        }
+    };
+    for (; x <= n - 16; x += 16)
+    {
+        cv::v_uint8x16 f[4], b[4];
+        cv::v_load_deinterleave(fg + 4 * x, f[0], f[1], f[2], f[3]);
+        cv::v_load_deinterleave(bg + 4 * x, b[0], b[1], b[2], b[3]);
+        cv::v_uint16x8 fl[4], fh[4], bl[4], bh[4];
+        for (int c = 0; c < 4; ++c)
+        {
+            cv::v_expand(f[c], fl[c], fh[c]);
+            cv::v_expand(b[c], bl[c], bh[c]);
+        }
+        cv::v_uint16x8 ol[4], oh[4];
+        blend8(fl[3], bl[3], fl, bl, ol, ol[3]);
+        blend8(fh[3], bh[3], fh, bh, oh, oh[3]);
+        cv::v_store_interleave(out + 4 * x, cv::v_pack(ol[0], oh[0]), cv::v_pack(ol[1], oh[1]), cv::v_pack(ol[2], oh[2]), cv::v_pack(ol[3], oh[3]));
+    }
+#endif
+    for (; x < n; ++x)
+    {
+        const uchar *f = fg + 4 * x, *b = bg + 4 * x;
+        uchar *o = out + 4 * x;
+        const unsigned af = f[3], wb = b[3] * (255 - af), d = af * 255 + wb, t = d + 128;
+        const unsigned a = (t + (t >> 8)) >> 8;
+        for (int c = 0; c < 3; ++c)
+        {
+            const std::uint64_t num = f[c] * af * 255 + b[c] * wb;
+            o[c] = uchar(std::min<std::uint64_t>(255, (num * rcp[a] + (std::uint64_t(1) << 31)) >> 32));
+        }
+        o[3] = uchar(a);
+    }
+}
+
+/* 같은 크기 8UC4 두 장. out이 입력과 같은 Mat이어도 픽셀 단위라 안전 */
+inline void over(const cv::Mat &fgRGBA, const cv::Mat &bgRGBA, cv::Mat &outRGBA)
+{
+    CV_Assert(fgRGBA.type() == CV_8UC4 && bgRGBA.type() == CV_8UC4 && fgRGBA.size() == bgRGBA.size());
+    const cv::Mat fg = fgRGBA, bg = bgRGBA; // 헤더 보관
+    outRGBA.create(fg.size(), CV_8UC4);
+    cv::parallel_for_(cv::Range(0, fg.rows), [&](const cv::Range &r) {
+        for (int y = r.start; y < r.end; ++y)
+            overRow(fg.ptr<uchar>(y), bg.ptr<uchar>(y), outRGBA.ptr<uchar>(y), fg.cols);
+    });
+}
+} // namespace alphaover
+
+#endif // ALPHAOVER_H
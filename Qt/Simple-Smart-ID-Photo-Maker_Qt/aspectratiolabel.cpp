@@ -1,4 +1,5 @@
 #include "aspectratiolabel.h"
+#include <QElapsedTimer>
 
 AspectRatioLabel::AspectRatioLabel(QWidget *parent) : QLabel(parent)
 {
@@ -15,3 +16,11 @@ QSize AspectRatioLabel::sizeHint() const
     int w = this->width();
     return QSize(w, heightForWidth(w));
 }
+
+void AspectRatioLabel::paintEvent(QPaintEvent *event)
+{
+    QElapsedTimer t;
+    t.start();
+    QLabel::paintEvent(event);
+    emit painted(t.nsecsElapsed() / 1e6);
+}
@@ -12,6 +12,12 @@ public:
     int heightForWidth(int width) const override;
     QSize sizeHint() const override;
 
+signals:
+    void painted(double ms); // 한 번 그리는 데 걸린 시간(프리뷰 스케줄러 측정용)
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
 private:
     float ratio = 4.0f/3.0f;
 };
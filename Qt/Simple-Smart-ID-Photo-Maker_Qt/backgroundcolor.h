@@ -0,0 +1,60 @@
+#ifndef BACKGROUNDCOLOR_H
+#define BACKGROUNDCOLOR_H
+
+#include <QString>
+#include <array>
+#include <opencv2/opencv.hpp>
+
+/*
+ * 배경색 콤보박스(촬영/편집/내보내기 공통) 항목 이름 ↔ BGR 색
+ * - 항목 문자열은 각 .ui 파일의 콤보박스 항목과 같아야 함
+ */
+namespace BackgroundColor
+{
+struct Preset
+{
+    const char *name;
+    cv::Scalar bgr;
+};
+
+// 첫 항목이 기본색
+inline const std::array<Preset, 4> &presets()
+{
+    static const std::array<Preset, 4> table = {{
+        {"흰색", cv::Scalar(255, 255, 255)},
+        {"파란색", cv::Scalar(255, 0, 0)},
+        {"빨간색", cv::Scalar(0, 0, 255)},
+        {"회색", cv::Scalar(128, 128, 128)},
+    }};
+    return table;
+}
+
+// 항목 이름의 색. 모르는 이름이면 fallback
+inline cv::Scalar fromName(const QString &name, const cv::Scalar &fallback = cv::Scalar(255, 255, 255))
+{
+    for (const Preset &p : presets())
+        if (name == QString::fromUtf8(p.name))
+            return p.bgr;
+    return fallback;
+}
+
+// 색의 항목 이름. 목록에 없는 색은 흰색으로 표시
+inline QString nameOf(const cv::Scalar &bgr)
+{
+    for (const Preset &p : presets())
+        if (bgr == p.bgr)
+            return QString::fromUtf8(p.name);
+    return QString::fromUtf8(presets().front().name);
+}
+
+// 흑백 모드에서 배경이 실제로 갖는 회색(cvtColor BGR2GRAY와 같은 값)
+inline cv::Scalar toGray(const cv::Scalar &bgr)
+{
+    const cv::Mat color(1, 1, CV_8UC3, bgr);
+    cv::Mat gray;
+    cv::cvtColor(color, gray, cv::COLOR_BGR2GRAY);
+    return cv::Scalar::all(gray.at<uchar>(0));
+}
+} // namespace BackgroundColor
+
+#endif // BACKGROUNDCOLOR_H
@@ -0,0 +1,124 @@
+#include "composetask.h"
+#include <QtConcurrent/QtConcurrent>
+
+ComposeTask::ComposeTask(SuitComposer &composer, QObject *parent) : QObject(parent), comp_(composer)
+{
+    pool_.setMaxThreadCount(1);
+    connect(&watcher_, &QFutureWatcher<ComposeResult>::finished, this, &ComposeTask::onFinished);
+}
+
+ComposeTask::~ComposeTask()
+{
+    cancel();
+    if (warmUpCancel_)
+        *warmUpCancel_ = true;
+    pool_.waitForDone();
+}
+
+/* 이미 확보된 프레임으로 합성 */
+QFuture<ComposeResult> ComposeTask::start(const cv::Mat &frameBGR, const cv::Scalar &bgColor, const QString &savePath)
+{
+    cv::Mat frame = frameBGR.clone(); // 작업 스레드 소유 복사본
+    return start([frame](const std::function<bool()> &) { return frame; }, bgColor, savePath);
+}
+
+/* 이전 작업 취소 → 새 취소 플래그로 합성 작업 등록 */
+QFuture<ComposeResult> ComposeTask::start(FrameProvider frameProvider, const cv::Scalar &bgColor, const QString &savePath)
+{
+    cancel();
+    if (warmUpCancel_)
+        *warmUpCancel_ = true; // 촬영 우선: 실시간 매트 준비는 다음 반복 경계에서 중단
+    auto flag = std::make_shared<std::atomic<bool>>(false);
+    cancelFlag_ = flag;
+    const SuitComposer::Settings settings = comp_.settings(); // 제출 시점 설정(이후 GUI 변경과 무관)
+
+    QFuture<ComposeResult> future = QtConcurrent::run(&pool_, [this, frameProvider, bgColor, savePath, flag, settings]() {
+        ComposeResult result;
+        if (*flag)
+            return result;
+        result.savePath = savePath;
+
+        ComposeControl ctl;
+        ctl.cancelled = [flag]() { return flag->load(); };
+        ctl.progress = [this, flag](int p) {
+            if (!*flag)
+                emit progress(p);
+        };
+
+        try
+        {
+            const cv::Mat frame = frameProvider(ctl.cancelled);
+            if (frame.empty() || *flag)
+                return ComposeResult();
+            ctl.report(5);
+
+            result.rgba = comp_.composeRGBA(frame, settings, &ctl);
+            if (result.rgba.empty() || *flag)
+                return ComposeResult();
+            result.bgr = SuitComposer::flattenRGBA(result.rgba, bgColor);
+            result.bgColor = bgColor;
+            ctl.report(100);
+        }
+        catch (const cv::Exception &)
+        {
+            result = ComposeResult();
+        }
+        return result;
+    });
+    watcher_.setFuture(future);
+    return future;
+}
+
+/* 실시간 매트 색 모델 학습. 실패(예외 포함)/취소 시 false */
+QFuture<bool> ComposeTask::warmUp(const cv::Mat &frameBGR)
+{
+    cv::Mat frame = frameBGR.clone();
+    auto flag = std::make_shared<std::atomic<bool>>(false);
+    warmUpCancel_ = flag;
+    const SuitComposer::Settings settings = comp_.settings();
+    return QtConcurrent::run(&pool_, [this, frame, flag, settings]() {
+        if (*flag)
+            return false;
+        ComposeControl ctl;
+        ctl.cancelled = [flag]() { return flag->load(); };
+        try
+        {
+            return comp_.warmUpLiveMatte(frame, settings, &ctl) && !*flag;
+        }
+        catch (const cv::Exception &)
+        {
+            return false;
+        }
+    });
+}
+
+/* 진행 중 작업에 취소 요청(다음 단계 경계에서 중단) */
+void ComposeTask::cancel()
+{
+    if (cancelFlag_)
+        *cancelFlag_ = true;
+}
+
+bool ComposeTask::isRunning() const { return watcher_.isRunning(); }
+
+/* GUI 스레드: 최신 작업 완료 처리. 취소된 작업은 조용히 무시 */
+void ComposeTask::onFinished()
+{
+    if (!cancelFlag_ || *cancelFlag_)
+        return;
+    ComposeResult result = watcher_.result();
+    if (result.bgr.empty())
+    {
+        emit failed();
+        return;
+    }
+
+    // 디스크 저장은 선택 사항: 인코딩/쓰기를 전역 풀에서 수행하고 결과는 바로 전달
+    if (!result.savePath.isEmpty())
+    {
+        const cv::Mat bgr = result.bgr; // 읽기 전용 공유
+        const QString path = result.savePath;
+        (void)QtConcurrent::run([bgr, path]() { cv::imwrite(path.toStdString(), bgr, {cv::IMWRITE_JPEG_QUALITY, 95}); });
+    }
+    emit composed(result);
+}
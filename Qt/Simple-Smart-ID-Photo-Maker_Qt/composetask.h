@@ -0,0 +1,65 @@
+#ifndef COMPOSETASK_H
+#define COMPOSETASK_H
+
+#include "suitcomposer.h"
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QObject>
+#include <QThreadPool>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// 작업 스레드에서 합성할 프레임을 얻는 함수. cancelled()가 true면 기다리지 말고 빈 Mat 반환
+using FrameProvider = std::function<cv::Mat(const std::function<bool()> &cancelled)>;
+
+// 백그라운드 합성 결과
+struct ComposeResult
+{
+    cv::Mat bgr;        // 배경색 적용된 최종 BGR
+    cv::Mat rgba;       // 배경색 적용 전 합성 RGBA(알파 매트 포함)
+    cv::Scalar bgColor; // bgr에 적용된 배경색(BGR)
+    QString savePath;   // 백그라운드 저장 경로(저장 안 함이면 빈 문자열)
+};
+
+/*
+ * 촬영 프레임 → 수트 합성을 백그라운드에서 수행하는 작업 관리자
+ * - start()는 즉시 QFuture를 반환하고, 진행률은 progress()로 GUI 스레드에 전달
+ * - 진행 중에 start()/cancel()이 오면 이전 작업은 다음 단계 경계에서 중단
+ * - 같은 SuitComposer를 쓰므로 전용 스레드 1개에서 작업을 순서대로 실행
+ * - 합성 설정은 제출 시점에 스냅샷(SuitComposer::settings())으로 작업에 넘김. 작업 중 설정 변경은 다음 작업부터
+ */
+class ComposeTask : public QObject
+{
+    Q_OBJECT
+  public:
+    explicit ComposeTask(SuitComposer &composer, QObject *parent = nullptr);
+    ~ComposeTask() override;
+
+    // 합성 시작(진행 중 작업은 취소). savePath가 비어 있지 않으면 결과 전달과 별개로 JPG를 백그라운드 저장
+    QFuture<ComposeResult> start(const cv::Mat &frameBGR, const cv::Scalar &bgColor, const QString &savePath);
+    // 프레임을 작업 스레드에서 얻는 버전(고해상도 스틸 대기/전체 디코드를 GUI 스레드 밖에서 수행)
+    QFuture<ComposeResult> start(FrameProvider frameProvider, const cv::Scalar &bgColor, const QString &savePath);
+    void cancel();
+    bool isRunning() const;
+    // 실시간 매트 준비(분할만, 합성 작업과 같은 스레드에서 순서대로). 시그널 없음
+    // start()가 오면 진행 중/대기 중 준비는 취소(촬영이 뒤에서 기다리지 않게), 결과는 false
+    QFuture<bool> warmUp(const cv::Mat &frameBGR);
+
+  signals:
+    void progress(int percent);
+    void composed(const ComposeResult &result); // 취소되지 않고 성공한 작업만
+    void failed();
+
+  private slots:
+    void onFinished();
+
+  private:
+    SuitComposer &comp_;
+    QThreadPool pool_; // 스레드 1개: 취소된 작업이 빠진 뒤 다음 작업 실행
+    QFutureWatcher<ComposeResult> watcher_;
+    std::shared_ptr<std::atomic<bool>> cancelFlag_;
+    std::shared_ptr<std::atomic<bool>> warmUpCancel_; // 마지막 실시간 매트 준비 작업
+};
+
+#endif // COMPOSETASK_H
@@ -1,11 +1,14 @@
 #include "export_page.h"
+#include "backgroundcolor.h"
 #include "ui_export_page.h"
+#include "suitcomposer.h"
 #include <QDir>
 #include <QFile>
 #include <QFileDialog>
 #include <QImage>
 #include <QMessageBox>
 #include <QPixmap>
+#include <QSignalBlocker>
 
 export_page::export_page(QWidget *parent) : QWidget(parent), ui(new Ui::export_page), selectedFormat("jpg")
 {
@@ -31,7 +34,7 @@ void export_page::resizeEvent(QResizeEvent *event)
     }
 }
 
-void export_page::setResultImage(const cv::Mat &image)
+void export_page::setResultImage(const cv::Mat &image, const cv::Mat &alpha, const cv::Scalar &bgColor, bool grayscale)
 {
     if (image.empty())
     {
@@ -40,20 +43,34 @@ void export_page::setResultImage(const cv::Mat &image)
     }
 
     resultImage = image.clone();
+    resultAlpha = image.type() == CV_8UC3 && alpha.size() == image.size() ? alpha : cv::Mat();
+    resultGrayscale = grayscale;
+    resultBackgroundColor = grayscale ? BackgroundColor::toGray(bgColor) : bgColor;
+    ui->background_select_combo->setEnabled(!resultAlpha.empty());
 
+    // 콤보박스 표시만 현재 배경색에 맞춤(슬롯 호출 없음)
+    {
+        const QSignalBlocker blocker(ui->background_select_combo);
+        ui->background_select_combo->setCurrentText(BackgroundColor::nameOf(bgColor));
+    }
+    showResultImage();
+}
+
+void export_page::showResultImage()
+{
     // OpenCV Mat을 QImage로 변환
     cv::Mat display_image;
-    if (image.channels() == 3)
+    if (resultImage.channels() == 3)
     {
-        cv::cvtColor(image, display_image, cv::COLOR_BGR2RGB);
+        cv::cvtColor(resultImage, display_image, cv::COLOR_BGR2RGB);
     }
-    else if (image.channels() == 1)
+    else if (resultImage.channels() == 1)
     {
-        cv::cvtColor(image, display_image, cv::COLOR_GRAY2RGB);
+        cv::cvtColor(resultImage, display_image, cv::COLOR_GRAY2RGB);
     }
     else
     {
-        display_image = image.clone();
+        display_image = resultImage.clone();
     }
 
     QImage qimg(display_image.data, display_image.cols, display_image.rows, display_image.step, QImage::Format_RGB888);
@@ -66,6 +83,26 @@ void export_page::setResultImage(const cv::Mat &image)
 
 void export_page::on_file_format_select_combo_currentTextChanged(const QString &text) { selectedFormat = text.toLower(); }
 
+// 배경색 변경: 합성 알파로 현재 결과의 배경만 교체(재촬영/재분할 없음)
+void export_page::on_background_select_combo_currentTextChanged(const QString &text)
+{
+    if (resultImage.empty() || resultAlpha.empty())
+    {
+        return;
+    }
+
+    // 흑백 결과는 배경도 회색조로 교체
+    cv::Scalar color = BackgroundColor::fromName(text);
+    if (resultGrayscale)
+    {
+        color = BackgroundColor::toGray(color);
+    }
+
+    SuitComposer::rebaseBackground(resultImage, resultAlpha, resultBackgroundColor, color, resultImage);
+    resultBackgroundColor = color;
+    showResultImage();
+}
+
 QString export_page::generateUniqueFileName(const QString &baseName, const QString &extension)
 {
     QString currentDir = QDir::currentPath();
@@ -17,20 +17,27 @@ class export_page : public QWidget
   public:
     explicit export_page(QWidget *parent = nullptr);
     ~export_page();
-    void setResultImage(const cv::Mat &image);
+    // alpha: image와 같은 크기의 합성 알파(없으면 배경색 변경 불가), bgColor: 선택된 배경색
+    // grayscale: 흑백 결과(배경은 bgColor의 회색조로 들어 있고, 바꿀 때도 회색조로 교체)
+    void setResultImage(const cv::Mat &image, const cv::Mat &alpha = cv::Mat(), const cv::Scalar &bgColor = cv::Scalar(255, 255, 255), bool grayscale = false);
 
   protected:
     void resizeEvent(QResizeEvent *event) override;
 
   private slots:
     void on_file_format_select_combo_currentTextChanged(const QString &text);
+    void on_background_select_combo_currentTextChanged(const QString &text);
     void on_export_button_clicked();
 
   private:
     Ui::export_page *ui;
     cv::Mat resultImage;
+    cv::Mat resultAlpha;
+    cv::Scalar resultBackgroundColor = cv::Scalar(255, 255, 255); // resultImage에 실제로 들어 있는 배경색
+    bool resultGrayscale = false;
     QString selectedFormat;
     QString generateUniqueFileName(const QString &baseName, const QString &extension);
+    void showResultImage();
 };
 
 #endif // EXPORT_PAGE_H
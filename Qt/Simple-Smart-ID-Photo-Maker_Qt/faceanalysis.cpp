@@ -0,0 +1,85 @@
+#include "faceanalysis.h"
+#include "framecontext.h"
+#include "modelregistry.h"
+#include <algorithm>
+using namespace cv;
+
+/* 전용 캐스케이드 인스턴스 구성(로드가 끝난 뒤라 기다리지 않음) */
+void FaceAnalyzer::prepareCascades()
+{
+    if (prepared_)
+        return;
+    prepared_ = true;
+    ModelRegistry &models = ModelRegistry::instance();
+    if (const Ptr<CascadeClassifier> det = models.createFaceCascade())
+        faceDet_ = *det;
+    if (const Ptr<CascadeClassifier> det = models.createEyeCascade())
+        eyeDet_ = *det;
+}
+
+/* 얼굴(축소 영상) → 얼굴 상단에서 눈 */
+FaceAnalysis FaceAnalyzer::analyze(const Mat &bgr)
+{
+    FaceAnalysis a;
+    a.imageSize = bgr.size();
+    if (bgr.empty() || cancelled_)
+        return a;
+    prepareCascades();
+    FrameContext frame(bgr);
+
+    // 얼굴 검출은 축소 피라미드 단계에서(고해상도 합성 결과도 폭 400 이하로)
+    if (!faceDet_.empty())
+    {
+        std::vector<Rect> faces;
+        const Mat &gray = frame.equalizedLevel(frame.levelForWidth(400));
+        const double s = double(gray.cols) / bgr.cols;
+        const int minSize = std::max(24, int(80 * s));
+        faceDet_.detectMultiScale(gray, faces, 1.1, 5, 0, Size(minSize, minSize));
+        if (!faces.empty())
+        {
+            const Rect &f = faces[0];
+            a.face = Rect(int(f.x / s), int(f.y / s), int(f.width / s), int(f.height / s)) & Rect(Point(), bgr.size());
+        }
+    }
+    if (!a.hasFace() || cancelled_)
+        return a;
+
+    // 눈: 얼굴 상단 2/3만 지역 평활화 후 검출, 큰 것 2개를 왼쪽부터
+    a.eyeModel = !eyeDet_.empty();
+    if (a.eyeModel)
+    {
+        const Rect upper(a.face.x, a.face.y, a.face.width, std::max(1, a.face.height * 2 / 3));
+        std::vector<Rect> eyes;
+        eyeDet_.detectMultiScale(frame.equalizedGray(upper), eyes, 1.05, 2, 0, Size(10, 10), Size(100, 100));
+        if (eyes.size() > 2)
+        {
+            std::sort(eyes.begin(), eyes.end(), [](const Rect &l, const Rect &r) { return l.area() > r.area(); });
+            eyes.resize(2);
+        }
+        std::sort(eyes.begin(), eyes.end(), [](const Rect &l, const Rect &r) { return l.x < r.x; });
+        for (Rect &e : eyes)
+            e += upper.tl();
+        a.eyes = std::move(eyes);
+    }
+    return a;
+}
+
+/* 얼굴 사각형으로 68점 랜드마크(저장소 인스턴스: 이 분석기만 fit 호출). 모델이 없거나 실패하면 빈 벡터 */
+std::vector<Point2f> FaceAnalyzer::fitLandmarks(const Mat &bgr, const Rect &face)
+{
+    const Ptr<face::Facemark> facemark = ModelRegistry::instance().facemark().result();
+    if (!facemark || bgr.empty() || face.area() == 0 || cancelled_)
+        return {};
+    Mat gray;
+    cvtColor(bgr, gray, COLOR_BGR2GRAY);
+    std::vector<std::vector<Point2f>> shapes;
+    try
+    {
+        if (facemark->fit(gray, std::vector<Rect>{face}, shapes) && !shapes.empty())
+            return std::move(shapes[0]);
+    }
+    catch (const cv::Exception &)
+    {
+    }
+    return {};
+}
@@ -0,0 +1,48 @@
+#ifndef FACEANALYSIS_H
+#define FACEANALYSIS_H
+
+#include <atomic>
+#include <opencv2/face.hpp>
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+/*
+ * 원본 이미지 한 장의 얼굴 분석 결과(얼굴 사각형, 눈 사각형, 랜드마크)
+ * - 원본 픽셀 좌표. 같은 이미지라면 보정(선명도/잡티/눈 크기/치아 미백)을 바꿔도 다시 계산하지 않음
+ */
+struct FaceAnalysis
+{
+    cv::Size imageSize;
+    cv::Rect face;                      // 없으면 빈 Rect
+    std::vector<cv::Rect> eyes;         // 검출된 눈(최대 2개, 왼쪽부터)
+    bool eyeModel = false;              // 눈 검출기를 사용했는지(없었으면 눈 보정 안 함)
+    std::vector<cv::Point2f> landmarks; // 랜드마크 모델이 있으면 68점(fitLandmarks로 나중에 채움)
+    int serial = 0;                     // 분석 요청 번호(오래된 결과 구분용)
+
+    bool hasFace() const { return face.area() > 0; }
+};
+
+/*
+ * 얼굴/눈/랜드마크 분석기(작업 스레드 전용, 모델 로드를 기다리지 않음)
+ * - analyze(): 얼굴/눈. 모델 저장소의 얼굴/눈 캐스케이드 future가 끝난 뒤 호출(처음 한 번 전용 인스턴스 구성)
+ * - fitLandmarks(): 랜드마크. 저장소의 facemark future가 끝난 뒤 호출(느린 모델이 눈 보정을 막지 않게 따로)
+ * - 검출기를 공유하지 않도록 한 번에 한 스레드에서만 사용
+ * - cancel()(어느 스레드에서나) 후에는 다음 단계 경계에서 빈 결과를 돌려줌
+ */
+class FaceAnalyzer
+{
+  public:
+    FaceAnalysis analyze(const cv::Mat &bgr);
+    std::vector<cv::Point2f> fitLandmarks(const cv::Mat &bgr, const cv::Rect &face);
+    void cancel() { cancelled_ = true; }
+
+  private:
+    void prepareCascades();
+
+    std::atomic<bool> cancelled_{false};
+    bool prepared_ = false;
+    cv::CascadeClassifier faceDet_;
+    cv::CascadeClassifier eyeDet_;
+};
+
+#endif // FACEANALYSIS_H
@@ -0,0 +1,159 @@
+#include "facetracker.h"
+#include <algorithm>
+#include <chrono>
+using namespace cv;
+
+/* 두 사각형 겹침 비율(IoU) */
+static float overlapRatio(const Rect2f &a, const Rect2f &b)
+{
+    const float inter = (a & b).area();
+    const float uni = a.area() + b.area() - inter;
+    return uni > 0.f ? inter / uni : 0.f;
+}
+
+/* 검출기 교체(추적 상태 초기화) */
+void FaceTracker::setDetector(const CascadeClassifier &det)
+{
+    det_ = det;
+    reset();
+}
+
+void FaceTracker::reset()
+{
+    result_ = Result();
+    velocity_ = Point2f();
+    sinceFull_ = 0;
+    misses_ = 0;
+    lostSkip_ = 0;
+}
+
+/* 전체 프레임 검출: 피라미드 축소 단계에서 가장 큰 얼굴(없으면 빈 Rect) */
+cv::Rect FaceTracker::detectFull(FrameContext &frame)
+{
+    ++fullDetections_;
+    const Mat &gray = frame.equalizedLevel(frame.levelForWidth(params_.fullDetectWidth));
+    const double s = double(gray.cols) / frame.size().width;
+    std::vector<Rect> faces;
+    const int minSize = std::max(24, int(params_.minFaceSize * s));
+    det_.detectMultiScale(gray, faces, 1.1, 3, 0, Size(minSize, minSize));
+    if (faces.empty())
+        return {};
+    const Rect best = *std::max_element(faces.begin(), faces.end(), [](const Rect &a, const Rect &b) { return a.area() < b.area(); });
+    const Rect r(int(best.x / s), int(best.y / s), int(best.width / s), int(best.height / s));
+    return r & Rect(Point(), frame.size());
+}
+
+/* 예측 위치 주변 ROI만 회색조/평활화 후 좁은 크기 범위로 검출 */
+cv::Rect FaceTracker::detectNear(CascadeClassifier &det, FrameContext &frame, const Rect2f &ref, double margin, double scaleRange)
+{
+    const float mx = float(ref.width * margin), my = float(ref.height * margin);
+    const Rect roi = Rect(Rect2f(ref.x - mx, ref.y - my, ref.width + 2 * mx, ref.height + 2 * my)) & Rect(Point(), frame.size());
+    if (roi.width < 24 || roi.height < 24)
+        return {};
+
+    const Mat gray = frame.equalizedGray(roi);
+    const float side = std::max(ref.width, ref.height);
+    const int minSide = std::max(24, int(side * (1.0 - scaleRange)));
+    const int maxSide = std::max(minSide + 1, int(side * (1.0 + scaleRange)));
+    std::vector<Rect> faces;
+    det.detectMultiScale(gray, faces, 1.1, 3, 0, Size(minSide, minSide), Size(maxSide, maxSide));
+
+    Rect best;
+    float bestOverlap = -1.f;
+    for (const Rect &f : faces)
+    {
+        const Rect r = f + roi.tl();
+        const float o = overlapRatio(Rect2f(r), ref);
+        if (o > bestOverlap)
+        {
+            bestOverlap = o;
+            best = r;
+        }
+    }
+    return best;
+}
+
+const FaceTracker::Result &FaceTracker::update(const Mat &frameBGR)
+{
+    FrameContext frame(frameBGR);
+    return update(frame);
+}
+
+/* 검출(주기/분실 시 전체, 그 외 ROI) → 평활 → 신뢰도. 분실 중 전체 검출은 lostRedetectInterval 프레임마다 */
+const FaceTracker::Result &FaceTracker::update(FrameContext &frame)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    if (det_.empty() || frame.empty())
+    {
+        result_ = Result();
+        return result_;
+    }
+    if (frame.size() != frameSize_)
+    {
+        reset();
+        frameSize_ = frame.size();
+    }
+
+    const bool lost = result_.state == State::Lost;
+    if (lost && lostSkip_ > 0)
+    {
+        // 얼굴이 없는 동안은 lostRedetectInterval 프레임마다만 전체 검출
+        --lostSkip_;
+        result_.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        return result_;
+    }
+    const bool full = lost || ++sinceFull_ >= params_.redetectInterval;
+    const Rect2f predicted = result_.rect + velocity_;
+    Rect measured;
+    if (full)
+    {
+        measured = detectFull(frame);
+        sinceFull_ = 0;
+    }
+    else
+    {
+        ++roiDetections_;
+        measured = detectNear(det_, frame, predicted, params_.roiMargin, params_.scaleRange);
+    }
+
+    if (measured.area() > 0)
+    {
+        const Rect2f m(measured);
+        if (lost)
+        {
+            result_.rect = m;
+            velocity_ = Point2f();
+            result_.confidence = 1.f;
+        }
+        else
+        {
+            const float a = float(std::clamp(params_.smoothing, 0.0, 1.0));
+            const Point2f before = (result_.rect.tl() + result_.rect.br()) * 0.5f;
+            const Rect2f &p = predicted;
+            result_.rect = Rect2f(p.x + a * (m.x - p.x), p.y + a * (m.y - p.y), p.width + a * (m.width - p.width), p.height + a * (m.height - p.height));
+            const Point2f after = (result_.rect.tl() + result_.rect.br()) * 0.5f;
+            velocity_ = velocity_ * 0.5f + (after - before) * 0.5f;
+            // 전체 검출은 1, ROI 검출은 예측과 얼마나 맞았는지로
+            result_.confidence = full ? 1.f : 0.5f + 0.5f * overlapRatio(m, predicted);
+        }
+        result_.state = full ? State::Detected : State::Tracked;
+        misses_ = 0;
+    }
+    else if (!lost && ++misses_ <= params_.maxMisses)
+    {
+        // 잠깐 놓침(눈 감음/고개 돌림): 예측 위치로 유지, 신뢰도 감소
+        result_.rect = predicted;
+        velocity_ *= 0.5f;
+        result_.confidence *= 0.6f;
+        result_.state = State::Coasting;
+    }
+    else
+    {
+        reset();
+        if (lost)
+            lostSkip_ = std::max(0, params_.lostRedetectInterval - 1);
+    }
+
+    result_.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return result_;
+}
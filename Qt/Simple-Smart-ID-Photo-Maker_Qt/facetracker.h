@@ -0,0 +1,81 @@
+#ifndef FACETRACKER_H
+#define FACETRACKER_H
+
+#include "framecontext.h"
+#include <opencv2/opencv.hpp>
+
+/*
+ * 프레임 단위 얼굴 위치 추적(검출 후 추적)
+ * - 전체 프레임 검출은 N 프레임마다, 또는 추적을 잃은 다음 프레임에(축소 영상에서)
+ *   얼굴이 없는 동안에는 매 프레임이 아니라 M 프레임마다만 전체 검출(빈 화면에서 검출 비용 절감)
+ * - 그 사이에는 예측 위치 주변 ROI에서 직전 크기 ±범위의 좁은 스케일로만 검출
+ * - 사각형은 지수 평활, 매 프레임 신뢰도(0~1)와 상태 제공. 잠깐 놓치면 예측 위치로 유지(신뢰도 감소)
+ * 검출기는 이 객체 전용 인스턴스여야 함(CascadeClassifier는 스레드 간 공유 불가). 한 스레드에서만 사용
+ */
+class FaceTracker
+{
+  public:
+    enum class State
+    {
+        Lost,     // 얼굴 없음(lostRedetectInterval 프레임마다 전체 검출)
+        Detected, // 이번 프레임 전체 검출로 확인
+        Tracked,  // 이번 프레임 ROI 검출로 확인
+        Coasting  // 이번 프레임 놓침, 예측 위치 유지
+    };
+
+    struct Result
+    {
+        cv::Rect2f rect;        // 평활된 얼굴 사각형(입력 프레임 좌표)
+        float confidence = 0.f; // 0 = 없음, 1 = 전체 검출로 확인
+        State state = State::Lost;
+        double ms = 0.0; // 이번 update() 비용
+        bool valid() const { return state != State::Lost; }
+    };
+
+    struct Params
+    {
+        int redetectInterval = 15;    // 전체 검출 주기(프레임)
+        int lostRedetectInterval = 4; // 추적을 잃은 동안 전체 검출 주기(프레임, 1 = 매 프레임)
+        int maxMisses = 5;            // 연속으로 이만큼 넘게 놓치면 추적 잃음
+        double roiMargin = 0.5;       // ROI = 예측 사각형 + 사방으로 얼굴 크기 x margin
+        double scaleRange = 0.25;     // ROI 검출 크기 범위: 직전 크기 x (1 ± range)
+        double smoothing = 0.5;       // 새 측정 반영 비율(1 = 평활 없음)
+        int minFaceSize = 60;         // 전체 검출 최소 얼굴 크기(입력 프레임 픽셀)
+        int fullDetectWidth = 320;    // 전체 검출은 이 폭 이하로 줄인 영상에서
+    };
+
+    void setDetector(const cv::CascadeClassifier &det);
+    bool hasDetector() const { return !det_.empty(); }
+    void setParams(const Params &params) { params_ = params; }
+    const Params &params() const { return params_; }
+
+    // 한 프레임 처리(BGR). 크기가 바뀌면 처음부터
+    const Result &update(const cv::Mat &frameBGR);
+    // 다른 단계와 회색조/피라미드를 공유하는 버전
+    const Result &update(FrameContext &frame);
+    const Result &last() const { return result_; }
+    void reset();
+
+    // 누적 검출 횟수(비용 확인용)
+    int fullDetections() const { return fullDetections_; }
+    int roiDetections() const { return roiDetections_; }
+
+    // ref 주변 ROI에서 ref 크기 ±scaleRange 얼굴만 검출, ref와 가장 많이 겹치는 것(없으면 빈 Rect)
+    static cv::Rect detectNear(cv::CascadeClassifier &det, FrameContext &frame, const cv::Rect2f &ref, double margin, double scaleRange);
+
+  private:
+    cv::Rect detectFull(FrameContext &frame);
+
+    cv::CascadeClassifier det_;
+    Params params_;
+    Result result_;
+    cv::Point2f velocity_; // 중심 이동 평활값(프레임당)
+    cv::Size frameSize_;
+    int sinceFull_ = 0;
+    int misses_ = 0;
+    int lostSkip_ = 0; // 추적을 잃은 동안 남은 검출 생략 프레임
+    int fullDetections_ = 0;
+    int roiDetections_ = 0;
+};
+
+#endif // FACETRACKER_H
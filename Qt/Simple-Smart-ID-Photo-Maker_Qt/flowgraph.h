@@ -0,0 +1,347 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+// OpenCV modules/imgproc/src/gcgraph.hpp(GCGraph)를 옮겨 고친 것. 원 저작권/라이선스는 위와 같음
+
+#ifndef FLOWGRAPH_H
+#define FLOWGRAPH_H
+
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/*
+ * 그래프 컷용 최대 유량 그래프(Boykov-Kolmogorov, OpenCV GCGraph와 같은 방식)
+ * - reset()은 정점/간선을 비우되 메모리는 유지 → 반복마다 다시 만들어도 재할당 없음
+ * - 간선 인덱스 0/1은 "없음" 표시용으로 비워 둠, 정방향/역방향 간선은 인덱스 i, i^1 한 쌍
+ */
+template <typename TWeight> class FlowGraph
+{
+  public:
+    // 정점/간선 수 예약 후 비움(용량은 줄이지 않음)
+    void reset(std::size_t vtxCount, std::size_t edgeCount)
+    {
+        vtcs_.clear();
+        edges_.clear();
+        vtcs_.reserve(vtxCount);
+        edges_.reserve(edgeCount + 2);
+        edges_.resize(2);
+        flow_ = 0;
+    }
+
+    int addVtx()
+    {
+        vtcs_.push_back(Vtx());
+        return int(vtcs_.size()) - 1;
+    }
+
+    // i→j 용량 w, j→i 용량 revw
+    void addEdges(int i, int j, TWeight w, TWeight revw)
+    {
+        Edge fromI{j, vtcs_[i].first, w};
+        vtcs_[i].first = int(edges_.size());
+        edges_.push_back(fromI);
+        Edge toI{i, vtcs_[j].first, revw};
+        vtcs_[j].first = int(edges_.size());
+        edges_.push_back(toI);
+    }
+
+    // 소스→i 용량 sourceW, i→싱크 용량 sinkW(공통분은 바로 유량으로 처리)
+    void addTermWeights(int i, TWeight sourceW, TWeight sinkW)
+    {
+        const TWeight dw = vtcs_[i].weight;
+        if (dw > 0)
+            sourceW += dw;
+        else
+            sinkW -= dw;
+        flow_ += sourceW < sinkW ? sourceW : sinkW;
+        vtcs_[i].weight = sourceW - sinkW;
+    }
+
+    TWeight maxFlow();
+
+    // maxFlow() 후: 정점이 소스(전경) 쪽인지
+    bool inSourceSegment(int i) const { return vtcs_[i].t == 0; }
+
+  private:
+    struct Vtx
+    {
+        Vtx *next = nullptr; // 활성 목록 연결(nullptr = 목록에 없음)
+        int parent = 0;      // 트리 부모로 가는 간선(0 = 트리 밖, TERMINAL/ORPHAN)
+        int first = 0;       // 첫 간선
+        int ts = 0;          // 거리 계산 타임스탬프
+        int dist = 0;        // 터미널까지 거리
+        TWeight weight = 0;  // 남은 터미널 용량(+ 소스, - 싱크)
+        std::uint8_t t = 0;  // 0 = 소스 트리, 1 = 싱크 트리
+    };
+    struct Edge
+    {
+        int dst;
+        int next;
+        TWeight weight;
+    };
+
+    std::vector<Vtx> vtcs_;
+    std::vector<Edge> edges_;
+    std::vector<Vtx *> orphans_;
+    TWeight flow_ = 0;
+};
+
+/* 탐색 트리 확장 → 경로 증강 → 고아 정점 재연결 반복 */
+template <typename TWeight> TWeight FlowGraph<TWeight>::maxFlow()
+{
+    if (vtcs_.empty())
+        return flow_;
+    const int TERMINAL = -1, ORPHAN = -2;
+    Vtx stub, *nilNode = &stub, *first = nilNode, *last = nilNode;
+    int currTs = 0;
+    stub.next = nilNode;
+    Vtx *vtxPtr = vtcs_.data();
+    Edge *edgePtr = edges_.data();
+    orphans_.clear();
+
+    // 활성 목록과 정점 초기화
+    for (std::size_t i = 0; i < vtcs_.size(); ++i)
+    {
+        Vtx *v = vtxPtr + i;
+        v->ts = 0;
+        v->next = nullptr;
+        if (v->weight != 0)
+        {
+            last = last->next = v;
+            v->dist = 1;
+            v->parent = TERMINAL;
+            v->t = v->weight < 0;
+        }
+        else
+            v->parent = 0;
+    }
+    first = first->next;
+    last->next = nilNode;
+    nilNode->next = nullptr;
+
+    for (;;)
+    {
+        Vtx *v, *u;
+        int e0 = -1, ei = 0, ej = 0;
+        TWeight minWeight, weight;
+        std::uint8_t vt;
+
+        // S/T 트리 확장, 두 트리를 잇는 간선 찾기
+        while (first != nilNode)
+        {
+            v = first;
+            if (v->parent)
+            {
+                vt = v->t;
+                for (ei = v->first; ei != 0; ei = edgePtr[ei].next)
+                {
+                    if (edgePtr[ei ^ vt].weight == 0)
+                        continue;
+                    u = vtxPtr + edgePtr[ei].dst;
+                    if (!u->parent)
+                    {
+                        u->t = vt;
+                        u->parent = ei ^ 1;
+                        u->ts = v->ts;
+                        u->dist = v->dist + 1;
+                        if (!u->next)
+                        {
+                            u->next = nilNode;
+                            last = last->next = u;
+                        }
+                        continue;
+                    }
+                    if (u->t != vt)
+                    {
+                        e0 = ei ^ vt;
+                        break;
+                    }
+                    if (u->dist > v->dist + 1 && u->ts <= v->ts)
+                    {
+                        // 더 짧은 쪽으로 부모 교체
+                        u->parent = ei ^ 1;
+                        u->ts = v->ts;
+                        u->dist = v->dist + 1;
+                    }
+                }
+                if (e0 > 0)
+                    break;
+            }
+            // 활성 목록에서 제외
+            first = first->next;
+            v->next = nullptr;
+        }
+
+        if (e0 <= 0)
+            break;
+
+        // 경로의 최소 잔여 용량(k = 1: 소스 트리 쪽, k = 0: 싱크 트리 쪽)
+        minWeight = edgePtr[e0].weight;
+        for (int k = 1; k >= 0; --k)
+        {
+            for (v = vtxPtr + edgePtr[e0 ^ k].dst;; v = vtxPtr + edgePtr[ei].dst)
+            {
+                if ((ei = v->parent) < 0)
+                    break;
+                weight = edgePtr[ei ^ k].weight;
+                minWeight = weight < minWeight ? weight : minWeight;
+            }
+            weight = std::abs(v->weight);
+            minWeight = weight < minWeight ? weight : minWeight;
+        }
+
+        // 경로 용량 갱신, 포화된 간선의 정점은 고아로
+        edgePtr[e0].weight -= minWeight;
+        edgePtr[e0 ^ 1].weight += minWeight;
+        flow_ += minWeight;
+        for (int k = 1; k >= 0; --k)
+        {
+            for (v = vtxPtr + edgePtr[e0 ^ k].dst;; v = vtxPtr + edgePtr[ei].dst)
+            {
+                if ((ei = v->parent) < 0)
+                    break;
+                edgePtr[ei ^ (k ^ 1)].weight += minWeight;
+                if ((edgePtr[ei ^ k].weight -= minWeight) == 0)
+                {
+                    orphans_.push_back(v);
+                    v->parent = ORPHAN;
+                }
+            }
+            v->weight = v->weight + minWeight * (1 - k * 2);
+            if (v->weight == 0)
+            {
+                orphans_.push_back(v);
+                v->parent = ORPHAN;
+            }
+        }
+
+        // 고아 정점에 새 부모 찾기
+        ++currTs;
+        while (!orphans_.empty())
+        {
+            Vtx *v2 = orphans_.back();
+            orphans_.pop_back();
+
+            int d, minDist = INT_MAX;
+            e0 = 0;
+            vt = v2->t;
+
+            for (ei = v2->first; ei != 0; ei = edgePtr[ei].next)
+            {
+                if (edgePtr[ei ^ (vt ^ 1)].weight == 0)
+                    continue;
+                u = vtxPtr + edgePtr[ei].dst;
+                if (u->t != vt || u->parent == 0)
+                    continue;
+                // 루트까지 거리 계산
+                for (d = 0;;)
+                {
+                    if (u->ts == currTs)
+                    {
+                        d += u->dist;
+                        break;
+                    }
+                    ej = u->parent;
+                    d++;
+                    if (ej < 0)
+                    {
+                        if (ej == ORPHAN)
+                            d = INT_MAX - 1;
+                        else
+                        {
+                            u->ts = currTs;
+                            u->dist = 1;
+                        }
+                        break;
+                    }
+                    u = vtxPtr + edgePtr[ej].dst;
+                }
+
+                // 거리 갱신
+                if (++d < INT_MAX)
+                {
+                    if (d < minDist)
+                    {
+                        minDist = d;
+                        e0 = ei;
+                    }
+                    for (u = vtxPtr + edgePtr[ei].dst; u->ts != currTs; u = vtxPtr + edgePtr[u->parent].dst)
+                    {
+                        u->ts = currTs;
+                        u->dist = --d;
+                    }
+                }
+            }
+
+            if ((v2->parent = e0) > 0)
+            {
+                v2->ts = currTs;
+                v2->dist = minDist;
+                continue;
+            }
+
+            // 부모 없음: 트리에서 떼어내고 이웃을 다시 활성화
+            v2->ts = 0;
+            for (ei = v2->first; ei != 0; ei = edgePtr[ei].next)
+            {
+                u = vtxPtr + edgePtr[ei].dst;
+                ej = u->parent;
+                if (u->t != vt || !ej)
+                    continue;
+                if (edgePtr[ei ^ (vt ^ 1)].weight && !u->next)
+                {
+                    u->next = nilNode;
+                    last = last->next = u;
+                }
+                if (ej > 0 && vtxPtr + edgePtr[ej].dst == v2)
+                {
+                    orphans_.push_back(u);
+                    u->parent = ORPHAN;
+                }
+            }
+        }
+    }
+    return flow_;
+}
+
+#endif // FLOWGRAPH_H
@@ -0,0 +1,80 @@
+#include "framecontext.h"
+#include <algorithm>
+using namespace cv;
+
+namespace
+{
+constexpr int kMinLevelSide = 32; // 이보다 작아지면 더 줄이지 않음
+constexpr int kMaxLevels = 16;    // 미리 예약 → 단계를 늘려도 앞서 돌려준 참조가 유지됨
+}
+
+void FrameContext::reset(const Mat &bgr)
+{
+    CV_Assert(bgr.empty() || bgr.type() == CV_8UC3);
+    bgr_ = bgr;
+    gray_.clear();
+    equalized_.clear();
+}
+
+const cv::Mat &FrameContext::gray()
+{
+    if (gray_.empty())
+    {
+        gray_.reserve(kMaxLevels);
+        equalized_.reserve(kMaxLevels);
+        gray_.emplace_back();
+        if (!bgr_.empty())
+            cvtColor(bgr_, gray_[0], COLOR_BGR2GRAY);
+    }
+    return gray_[0];
+}
+
+/* 필요한 단계까지만 pyrDown(이미 만든 단계는 재사용) */
+const cv::Mat &FrameContext::grayLevel(int level)
+{
+    gray();
+    level = std::clamp(level, 0, kMaxLevels - 1);
+    while (int(gray_.size()) <= level)
+    {
+        const Mat &prev = gray_.back();
+        if (std::min(prev.cols, prev.rows) / 2 < kMinLevelSide)
+            return gray_.back();
+        Mat next;
+        pyrDown(prev, next);
+        gray_.push_back(next);
+    }
+    return gray_[level];
+}
+
+const cv::Mat &FrameContext::equalizedLevel(int level)
+{
+    const Mat &g = grayLevel(level);
+    level = std::min(std::max(0, level), int(gray_.size()) - 1);
+    if (int(equalized_.size()) <= level)
+        equalized_.resize(level + 1);
+    if (equalized_[level].empty() && !g.empty())
+        equalizeHist(g, equalized_[level]);
+    return equalized_[level];
+}
+
+int FrameContext::levelForWidth(int maxWidth) const
+{
+    int level = 0, w = bgr_.cols, h = bgr_.rows;
+    while (w > maxWidth && std::min(w, h) / 2 >= kMinLevelSide)
+    {
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+        ++level;
+    }
+    return level;
+}
+
+cv::Mat FrameContext::equalizedGray(const Rect &roi)
+{
+    const Mat &g = gray();
+    const Rect r = roi & Rect(0, 0, g.cols, g.rows);
+    Mat out;
+    if (r.area() > 0)
+        equalizeHist(g(r), out);
+    return out;
+}
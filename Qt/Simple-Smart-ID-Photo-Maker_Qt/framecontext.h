@@ -0,0 +1,44 @@
+#ifndef FRAMECONTEXT_H
+#define FRAMECONTEXT_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+/*
+ * 한 영상(프레임 또는 편집 이미지의 한 버전)에서 파생되는 표현을 처음 요청될 때 한 번만 계산해 보관
+ * - 회색조, 히스토그램 평활화 회색조, 회색조 피라미드(pyrDown, 단계별 평활화 포함)
+ * - 검출 단계들이 같은 컨텍스트를 받아 색 변환/피라미드를 공유
+ * 원본은 복사하지 않고 참조만 공유하므로, 원본 픽셀이 바뀌면 reset()으로 새 버전을 알려야 함
+ * 한 스레드에서만 사용
+ */
+class FrameContext
+{
+  public:
+    FrameContext() = default;
+    explicit FrameContext(const cv::Mat &bgr) { reset(bgr); }
+
+    // 새 영상/새 버전: 파생 데이터 폐기
+    void reset(const cv::Mat &bgr);
+    bool empty() const { return bgr_.empty(); }
+    const cv::Mat &bgr() const { return bgr_; }
+    cv::Size size() const { return bgr_.size(); }
+
+    const cv::Mat &gray();
+    const cv::Mat &equalizedGray() { return equalizedLevel(0); }
+
+    // 피라미드 단계(0 = 원 해상도, k = 1/2^k). 너무 작아지면 마지막 단계로 고정
+    const cv::Mat &grayLevel(int level);
+    const cv::Mat &equalizedLevel(int level);
+    // 폭이 maxWidth 이하가 되는 가장 얕은 단계(검출을 줄인 영상에서 할 때)
+    int levelForWidth(int maxWidth) const;
+
+    // 회색조의 roi만 평활화(눈/얼굴 주변 등 지역 대비가 필요한 검출용, 매번 새 Mat)
+    cv::Mat equalizedGray(const cv::Rect &roi);
+
+  private:
+    cv::Mat bgr_;
+    std::vector<cv::Mat> gray_;      // 피라미드 단계별 회색조
+    std::vector<cv::Mat> equalized_; // 단계별 평활화(필요한 단계만)
+};
+
+#endif // FRAMECONTEXT_H
@@ -0,0 +1,182 @@
+#include "framegrabber.h"
+#include <algorithm>
+#include <cmath>
+
+FrameGrabber::FrameGrabber(QObject *parent) : QThread(parent) {}
+
+FrameGrabber::~FrameGrabber() { stop(); }
+
+/* 공급원 교체 + 열기 */
+bool FrameGrabber::open(std::unique_ptr<FrameSource> source)
+{
+    stop();
+    buffer_.reset(); // 이전 공급원 메모리를 가리키는 프레임(공유 메모리 헤더 등) 제거
+    source_ = std::move(source);
+    return source_ && source_->open();
+}
+
+/* 공급원 교체 후 스레드 시작. 열기는 run()에서 */
+void FrameGrabber::openAsync(std::unique_ptr<FrameSource> source)
+{
+    stop();
+    buffer_.reset();
+    source_ = std::move(source);
+    if (source_)
+        start();
+}
+
+/* 캡처 루프 종료 후 스레드 합류 */
+void FrameGrabber::stop()
+{
+    requestInterruption();
+    standbyCond_.wakeAll();
+    wait();
+    failStillRequests();
+}
+
+/* 처리되지 못한 스틸 요청은 빈 결과로 마무리(이후 요청은 재개 전까지 즉시 빈 결과) */
+void FrameGrabber::failStillRequests()
+{
+    QMutexLocker lock(&stillMutex_);
+    stillAccepting_ = false;
+    for (auto &p : stillRequests_)
+        p.set_value(cv::Mat());
+    stillRequests_.clear();
+    stillPending_ = false;
+}
+
+/* 대기 모드 설정. 진입 시 밀린 스틸 요청을 끝내고, 해제 시 캡처 루프를 깨움 */
+void FrameGrabber::setStandby(bool on)
+{
+    {
+        QMutexLocker lock(&standbyMutex_);
+        if (standby_ == on)
+            return;
+        standby_ = on;
+        if (!on)
+            standbyCond_.wakeAll();
+    }
+    if (on)
+        failStillRequests(); // 재개 후 캡처 루프가 다시 받기 시작
+}
+
+bool FrameGrabber::isStandby() const
+{
+    QMutexLocker lock(&standbyMutex_);
+    return standby_;
+}
+
+/* 캡처 스레드: 대기 모드 동안 블록(주기적으로 종료 요청 확인) */
+bool FrameGrabber::waitWhileStandby()
+{
+    QMutexLocker lock(&standbyMutex_);
+    bool waited = false;
+    while (standby_ && !isInterruptionRequested())
+    {
+        standbyCond_.wait(&standbyMutex_, 200);
+        waited = true;
+    }
+    return waited;
+}
+
+/* 어느 스레드에서나: 스틸 요청 등록. 캡처 루프가 돌지 않거나 대기 중이면 즉시 빈 결과
+ * 확인과 등록을 같은 잠금 안에서: 대기 진입/정지는 이 잠금을 잡고 밀린 요청을 끝내므로 등록된 요청은 반드시 끝남 */
+std::shared_future<cv::Mat> FrameGrabber::requestStill()
+{
+    std::promise<cv::Mat> promise;
+    std::shared_future<cv::Mat> future = promise.get_future().share();
+    QMutexLocker lock(&stillMutex_);
+    if (!stillAccepting_ || isStandby())
+    {
+        promise.set_value(cv::Mat());
+        return future;
+    }
+    stillRequests_.push_back(std::move(promise));
+    stillPending_ = true;
+    return future;
+}
+
+/* 스틸을 프리뷰와 같은 종횡비로 가운데 크롭(프리뷰 구도와 일치) */
+static cv::Mat cropToAspect(const cv::Mat &img, cv::Size aspect)
+{
+    if (img.empty() || aspect.area() <= 0)
+        return img;
+    const double target = double(aspect.width) / aspect.height;
+    int w = img.cols, h = img.rows;
+    if (double(w) / h > target)
+        w = std::max(1, int(std::lround(h * target)));
+    else
+        h = std::max(1, int(std::lround(w / target)));
+    return img(cv::Rect((img.cols - w) / 2, (img.rows - h) / 2, w, h)).clone();
+}
+
+/* 캡처 스레드: 밀린 스틸 요청을 한 장으로 모두 처리 */
+void FrameGrabber::serviceStillRequests()
+{
+    std::vector<std::promise<cv::Mat>> requests;
+    {
+        QMutexLocker lock(&stillMutex_);
+        requests.swap(stillRequests_);
+        stillPending_ = false;
+    }
+    if (requests.empty())
+        return;
+    const cv::Mat still = cropToAspect(source_->grabStill(), source_->frameSize());
+    for (auto &p : requests)
+        p.set_value(still);
+}
+
+/* GUI 스레드: 알림 플래그를 먼저 내리고 최신 슬롯을 가져옴 */
+bool FrameGrabber::acquireLatest()
+{
+    notifyPending_.store(false, std::memory_order_release);
+    return buffer_.update();
+}
+
+/* 캡처 루프: back 슬롯에 직접 디코드 → 공개 → (필요 시) 알림 */
+void FrameGrabber::run()
+{
+    if (!source_)
+        return;
+    if (!source_->isOpened())
+    {
+        const bool ok = source_->open();
+        emit opened(ok);
+        if (!ok)
+        {
+            failStillRequests();
+            return;
+        }
+    }
+    {
+        QMutexLocker lock(&stillMutex_);
+        stillAccepting_ = !isStandby();
+    }
+    while (!isInterruptionRequested())
+    {
+        if (waitWhileStandby())
+        {
+            if (isInterruptionRequested())
+                break;
+            source_->drainStale();
+            QMutexLocker lock(&stillMutex_);
+            stillAccepting_ = !isStandby();
+        }
+        if (stillPending_.load(std::memory_order_acquire))
+            serviceStillRequests();
+
+        CapturedFrame &slot = buffer_.writeSlot();
+        if (!source_->read(slot))
+        {
+            msleep(10);
+            continue;
+        }
+        slot.seq = ++seq_;
+        slot.captureTime = std::chrono::steady_clock::now();
+        buffer_.publish();
+
+        if (!notifyPending_.exchange(true, std::memory_order_acq_rel))
+            emit frameReady();
+    }
+    failStillRequests();
+}
@@ -0,0 +1,80 @@
+#ifndef FRAMEGRABBER_H
+#define FRAMEGRABBER_H
+
+#include "framesource.h"
+#include "triplebuffer.h"
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+
+/*
+ * 캡처/디코드 전용 스레드(공급원은 FrameSource: 카메라/파일/이미지/합성)
+ * - 블로킹 read()를 GUI 스레드 밖에서 수행
+ * - 최신 프레임만 트리플 버퍼로 공개하고 frameReady()로 알림
+ * - GUI는 acquireLatest() 후 latest()로 front 프레임을 사용
+ * - 대기 모드: 장치는 연 채로 읽기/디코드만 멈춤, 해제 시 오래된 버퍼를 비우고 즉시 재개
+ * - 고해상도 스틸: 셔터 시에만 공급원의 grabStill()로 한 장 받아 프리뷰 종횡비로 크롭
+ */
+class FrameGrabber : public QThread
+{
+    Q_OBJECT
+  public:
+    explicit FrameGrabber(QObject *parent = nullptr);
+    ~FrameGrabber() override;
+
+    // 공급원 열기(스레드 시작 전에 호출, 호출 스레드에서 블록). 실패해도 공급원은 보관
+    bool open(std::unique_ptr<FrameSource> source);
+    // 비동기 시작: 공급원 열기(장치 협상 포함)를 캡처 스레드에서 수행하고 결과는 opened()로 알림
+    void openAsync(std::unique_ptr<FrameSource> source);
+    bool isOpened() const { return source_ && source_->isOpened(); }
+    const FrameSource *source() const { return source_.get(); }
+    void stop();
+
+    // 대기 모드 전환(화면이 가려졌을 때 true). 어느 스레드에서나 호출 가능
+    void setStandby(bool on);
+    bool isStandby() const;
+
+    // 고해상도 스틸 요청: 캡처 스레드가 다음 프레임 경계에서 처리(실패 시 빈 Mat)
+    // 대기 모드 진입/정지 시 처리되지 않은 요청은 빈 Mat으로 끝남(결과를 기다리는 쪽이 무한 대기하지 않음)
+    std::shared_future<cv::Mat> requestStill();
+
+    // 소비자(GUI 스레드): 새 프레임이 있으면 front로 교체하고 true
+    bool acquireLatest();
+    // 마지막으로 가져온 프레임(다음 acquireLatest() 전까지 유효)
+    const CapturedFrame &latest() const { return buffer_.readSlot(); }
+
+  signals:
+    // 새 프레임 공개됨(소비자가 가져갈 때까지 중복 발생하지 않음)
+    void frameReady();
+    // openAsync()의 공급원 열기 결과(캡처 스레드에서 발생)
+    void opened(bool ok);
+
+  protected:
+    void run() override;
+
+  private:
+    bool waitWhileStandby(); // 대기 중이었다가 재개되면 true
+    void serviceStillRequests();
+    void failStillRequests();
+
+    std::unique_ptr<FrameSource> source_; // 캡처 스레드 전용(시작 전 설정)
+    TripleBuffer<CapturedFrame> buffer_;
+    std::atomic<bool> notifyPending_{false};
+    quint64 seq_ = 0;
+
+    // 고해상도 스틸 요청
+    QMutex stillMutex_;
+    std::vector<std::promise<cv::Mat>> stillRequests_;
+    std::atomic<bool> stillPending_{false};
+    bool stillAccepting_ = false; // 캡처 루프가 요청을 처리할 수 있는 동안 true(stillMutex_ 보호)
+
+    mutable QMutex standbyMutex_;
+    QWaitCondition standbyCond_;
+    bool standby_ = false;
+};
+
+#endif // FRAMEGRABBER_H
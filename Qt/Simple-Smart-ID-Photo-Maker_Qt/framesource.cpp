@@ -0,0 +1,347 @@
+#include "framesource.h"
+#ifdef Q_OS_UNIX
+#include "shmringframesource.h"
+#endif
+#include <QDir>
+#include <QRegularExpression>
+#include <thread>
+
+/* t0 이후 경과 시간(ms) */
+static float msSince(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/* 비트스트림이 있으면 전체 해상도로 디코드, 없으면 프리뷰 프레임 복사 */
+cv::Mat CapturedFrame::fullResBGR() const
+{
+    if (!jpeg.empty())
+    {
+        cv::Mat full = cv::imdecode(jpeg, cv::IMREAD_COLOR);
+        if (!full.empty())
+            return full;
+    }
+    return bgr.clone();
+}
+
+// ============================================================================
+// FrameSource: 속도 조절 + 스펙 파싱
+// ============================================================================
+
+void FrameSource::setRate(double fps)
+{
+    fps_ = std::max(0.0, fps);
+    next_ = std::chrono::steady_clock::time_point();
+}
+
+/* rate > 0이면 고정 간격으로 다음 프레임 시각까지 대기(밀리면 기준 시각 재설정) */
+void FrameSource::pace()
+{
+    if (fps_ <= 0.0)
+        return;
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps_));
+    const auto now = std::chrono::steady_clock::now();
+    if (next_.time_since_epoch().count() == 0 || now - next_ > period)
+        next_ = now;
+    else
+        std::this_thread::sleep_until(next_);
+    next_ += period;
+}
+
+/* "종류:인자@fps" 스펙으로 백엔드 생성. 알 수 없는 스펙이면 nullptr */
+std::unique_ptr<FrameSource> FrameSource::create(const QString &spec)
+{
+    QString body = spec.trimmed();
+    double fps = -1.0;
+    const int at = body.lastIndexOf('@');
+    if (at >= 0)
+    {
+        bool ok = false;
+        const double v = body.mid(at + 1).toDouble(&ok);
+        if (ok)
+        {
+            fps = v;
+            body = body.left(at);
+        }
+    }
+
+    const int colon = body.indexOf(':');
+    const QString kind = (colon >= 0 ? body.left(colon) : body).toLower();
+    const QString arg = colon >= 0 ? body.mid(colon + 1) : QString();
+
+    std::unique_ptr<FrameSource> source;
+    if (kind.isEmpty() || kind == "v4l2")
+        source = std::make_unique<V4l2FrameSource>(arg.isEmpty() ? 0 : arg.toInt());
+    else if (kind == "file")
+        source = std::make_unique<VideoFileFrameSource>(arg);
+    else if (kind == "images")
+        source = std::make_unique<ImageSequenceFrameSource>(arg);
+    else if (kind == "synthetic")
+    {
+        cv::Size size(640, 480);
+        const QRegularExpressionMatch m = QRegularExpression("^(\\d+)x(\\d+)$").match(arg);
+        if (m.hasMatch())
+            size = cv::Size(m.captured(1).toInt(), m.captured(2).toInt());
+        source = std::make_unique<SyntheticFrameSource>(size);
+    }
+#ifdef Q_OS_UNIX
+    else if (kind == "shm")
+        source = std::make_unique<ShmRingFrameSource>(arg.isEmpty() ? QString("/idphoto_frames") : arg);
+#endif
+    if (source && fps >= 0.0)
+        source->setRate(fps);
+    return source;
+}
+
+// ============================================================================
+// V4L2 카메라
+// ============================================================================
+
+V4l2FrameSource::V4l2FrameSource(int device, cv::Size size) : device_(device), size_(size) {}
+
+V4l2FrameSource::~V4l2FrameSource()
+{
+    camera_.release();
+    stillCamera_.release();
+}
+
+void V4l2FrameSource::setStillResolution(cv::Size size, int stillDevice)
+{
+    stillSize_ = size;
+    stillDevice_ = stillDevice;
+}
+
+QString V4l2FrameSource::describe() const { return QString("v4l2:%1 %2x%3").arg(device_).arg(size_.width).arg(size_.height); }
+
+/* 카메라 열기: V4L2 우선, 실패 시 ANY. MJPG + 해상도 설정 */
+bool V4l2FrameSource::open()
+{
+    camera_.open(device_, cv::CAP_V4L2);
+    if (!camera_.isOpened())
+        camera_.open(device_, cv::CAP_ANY);
+    if (!camera_.isOpened())
+        return false;
+    camera_.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'));
+    camera_.set(cv::CAP_PROP_FRAME_WIDTH, size_.width);
+    camera_.set(cv::CAP_PROP_FRAME_HEIGHT, size_.height);
+
+    // 축소 디코드: 백엔드 변환을 끄고 원본 MJPEG 비트스트림 수신
+    if (decodeMode_ == DecodeMode::ReducedMjpeg && !camera_.set(cv::CAP_PROP_FORMAT, -1))
+        camera_.set(cv::CAP_PROP_CONVERT_RGB, 0);
+
+    // 스틸 전용 스트림: 미리 열고 한 장 받아 스트리밍/버퍼를 데워 둠(실패 시 해상도 전환 방식)
+    if (stillSize_.area() > 0 && stillDevice_ >= 0)
+    {
+        stillCamera_.open(stillDevice_, cv::CAP_V4L2);
+        if (stillCamera_.isOpened())
+        {
+            stillCamera_.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'));
+            stillCamera_.set(cv::CAP_PROP_FRAME_WIDTH, stillSize_.width);
+            stillCamera_.set(cv::CAP_PROP_FRAME_HEIGHT, stillSize_.height);
+            cv::Mat warm;
+            if (!stillCamera_.read(warm))
+                stillCamera_.release();
+        }
+    }
+    return true;
+}
+
+/* 한 프레임 수신. 1행 8U 버퍼면 MJPEG으로 보고 1/2 축소 디코드, 아니면 이미 디코드된 BGR */
+bool V4l2FrameSource::read(CapturedFrame &slot)
+{
+    if (!camera_.isOpened())
+        return false;
+    pace();
+    slot.decodeMs = 0.f;
+    if (decodeMode_ == DecodeMode::Full)
+    {
+        slot.jpeg.release();
+        // grab(장치 대기)과 retrieve(디코드)를 나눠 디코드 시간만 측정
+        if (!camera_.grab())
+            return false;
+        const auto t0 = std::chrono::steady_clock::now();
+        const bool ok = camera_.retrieve(slot.bgr) && !slot.bgr.empty();
+        slot.decodeMs = msSince(t0);
+        return ok;
+    }
+
+    if (!camera_.read(raw_) || raw_.empty())
+        return false;
+    if (raw_.rows == 1 && raw_.depth() == CV_8U && raw_.channels() == 1)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        raw_.copyTo(slot.jpeg); // 촬영 시 전체 디코드용(수신 버퍼는 다음 read에서 재사용됨)
+        cv::imdecode(slot.jpeg, cv::IMREAD_REDUCED_COLOR_2, &slot.bgr);
+        slot.decodeMs = msSince(t0);
+        return !slot.bgr.empty();
+    }
+
+    // 백엔드가 원본 모드를 지원하지 않음 → 디코드된 프레임 그대로 사용
+    slot.jpeg.release();
+    raw_.copyTo(slot.bgr);
+    return true;
+}
+
+/* 드라이버 큐에 남은 오래된 프레임을 디코드 없이 버림 */
+void V4l2FrameSource::drain(cv::VideoCapture &cap)
+{
+    int queued = int(cap.get(cv::CAP_PROP_BUFFERSIZE));
+    if (queued <= 0)
+        queued = 4; // V4L2 기본 버퍼 수
+    for (int i = 0; i < queued; ++i)
+        cap.grab();
+}
+
+void V4l2FrameSource::drainStale() { drain(camera_); }
+
+/* 고해상도 한 장 획득 후 전체 디코드 */
+cv::Mat V4l2FrameSource::grabStill()
+{
+    cv::Mat still;
+    if (stillSize_.area() <= 0)
+        return still;
+    if (stillCamera_.isOpened())
+    {
+        // 미리 데워 둔 두 번째 스트림: 쌓인 오래된 프레임만 버리고 바로 읽기
+        drain(stillCamera_);
+        if (!stillCamera_.read(still))
+            still.release();
+        return still;
+    }
+
+    // 해상도 전환 → 안정화 프레임 버림 → 한 장 → 프리뷰 해상도로 복귀
+    camera_.set(cv::CAP_PROP_FRAME_WIDTH, stillSize_.width);
+    camera_.set(cv::CAP_PROP_FRAME_HEIGHT, stillSize_.height);
+    for (int i = 0; i < stillWarmupFrames_; ++i)
+        camera_.grab();
+    // read()를 거치지 않음: 축소 디코드 없이 비트스트림을 전체 해상도로 한 번만 디코드
+    if (camera_.read(raw_) && !raw_.empty())
+    {
+        if (raw_.rows == 1 && raw_.depth() == CV_8U && raw_.channels() == 1)
+            cv::imdecode(raw_, cv::IMREAD_COLOR, &still);
+        else
+            raw_.copyTo(still);
+    }
+    camera_.set(cv::CAP_PROP_FRAME_WIDTH, size_.width);
+    camera_.set(cv::CAP_PROP_FRAME_HEIGHT, size_.height);
+    return still;
+}
+
+// ============================================================================
+// 동영상 파일
+// ============================================================================
+
+VideoFileFrameSource::VideoFileFrameSource(const QString &path) : path_(path) {}
+
+bool VideoFileFrameSource::open()
+{
+    if (!cap_.open(path_.toStdString()))
+        return false;
+    size_ = cv::Size(int(cap_.get(cv::CAP_PROP_FRAME_WIDTH)), int(cap_.get(cv::CAP_PROP_FRAME_HEIGHT)));
+    return true;
+}
+
+bool VideoFileFrameSource::read(CapturedFrame &slot)
+{
+    if (!cap_.isOpened())
+        return false;
+    pace();
+    slot.jpeg.release();
+    const auto t0 = std::chrono::steady_clock::now();
+    bool ok = cap_.read(slot.bgr) && !slot.bgr.empty();
+    if (!ok)
+    {
+        // 끝 → 되감기 후 한 번 더
+        cap_.set(cv::CAP_PROP_POS_FRAMES, 0);
+        ok = cap_.read(slot.bgr) && !slot.bgr.empty();
+    }
+    slot.decodeMs = msSince(t0);
+    return ok;
+}
+
+// ============================================================================
+// 이미지 디렉터리
+// ============================================================================
+
+ImageSequenceFrameSource::ImageSequenceFrameSource(const QString &dir) : dir_(dir) {}
+
+bool ImageSequenceFrameSource::open()
+{
+    QDir d(dir_);
+    files_.clear();
+    for (const QString &name : d.entryList({"*.png", "*.jpg", "*.jpeg", "*.bmp"}, QDir::Files, QDir::Name))
+        files_ << d.filePath(name);
+    index_ = 0;
+    if (files_.isEmpty())
+        return false;
+    const cv::Mat first = cv::imread(files_.first().toStdString(), cv::IMREAD_COLOR);
+    size_ = first.size();
+    return !first.empty();
+}
+
+bool ImageSequenceFrameSource::read(CapturedFrame &slot)
+{
+    if (files_.isEmpty())
+        return false;
+    pace();
+    slot.jpeg.release();
+    const auto t0 = std::chrono::steady_clock::now();
+    slot.bgr = cv::imread(files_[index_].toStdString(), cv::IMREAD_COLOR);
+    slot.decodeMs = msSince(t0);
+    index_ = (index_ + 1) % files_.size();
+    return !slot.bgr.empty();
+}
+
+// ============================================================================
+// 결정적 합성 프레임
+// ============================================================================
+
+SyntheticFrameSource::SyntheticFrameSource(cv::Size size, quint64 seed) : size_(size), seed_(seed) {}
+
+/* 고정 배경(세로 그라데이션) 한 번만 생성 */
+bool SyntheticFrameSource::open()
+{
+    if (size_.area() <= 0)
+        return false;
+    background_.create(size_, CV_8UC3);
+    for (int y = 0; y < size_.height; ++y)
+    {
+        const int t = 255 * y / std::max(1, size_.height - 1);
+        background_.row(y).setTo(cv::Scalar(200 - t / 4, 180 - t / 5, 150 + t / 5));
+    }
+    index_ = 0;
+    return true;
+}
+
+/* 프레임 번호만으로 결정되는 장면: 좌우로 흔들리는 얼굴 타원 + 어깨 + 노이즈 */
+bool SyntheticFrameSource::read(CapturedFrame &slot)
+{
+    if (background_.empty())
+        return false;
+    pace();
+    slot.jpeg.release();
+    slot.decodeMs = 0.f; // 디코드 없음
+    background_.copyTo(slot.bgr);
+
+    const int w = size_.width, h = size_.height;
+    const double phase = double(index_ % 120) / 120.0 * 2.0 * CV_PI;
+    const cv::Point center(int(w * (0.5 + 0.05 * std::sin(phase))), int(h * 0.42));
+    const cv::Size axes(int(w * 0.11), int(h * 0.19));
+
+    // 어깨(상체) → 목 → 얼굴 → 눈 순서로 그림
+    cv::ellipse(slot.bgr, cv::Point(center.x, h + h / 6), cv::Size(int(w * 0.35), int(h * 0.4)), 0, 180, 360, cv::Scalar(60, 50, 45), cv::FILLED, cv::LINE_AA);
+    cv::rectangle(slot.bgr, cv::Rect(center.x - axes.width / 2, center.y + axes.height / 2, axes.width, axes.height), cv::Scalar(120, 150, 200), cv::FILLED);
+    cv::ellipse(slot.bgr, center, axes, 0, 0, 360, cv::Scalar(130, 165, 215), cv::FILLED, cv::LINE_AA);
+    const cv::Size eye(std::max(2, axes.width / 5), std::max(1, axes.height / 10));
+    cv::ellipse(slot.bgr, center + cv::Point(-axes.width / 2, -axes.height / 5), eye, 0, 0, 360, cv::Scalar(40, 30, 30), cv::FILLED, cv::LINE_AA);
+    cv::ellipse(slot.bgr, center + cv::Point(axes.width / 2, -axes.height / 5), eye, 0, 0, 360, cv::Scalar(40, 30, 30), cv::FILLED, cv::LINE_AA);
+
+    // 시드 + 프레임 번호 고정 노이즈(센서 노이즈 흉내, 재현 가능)
+    cv::Mat noise(size_, CV_8UC3);
+    cv::RNG rng(seed_ * 0x9E3779B97F4A7C15ULL + index_);
+    rng.fill(noise, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(8));
+    cv::add(slot.bgr, noise, slot.bgr);
+
+    ++index_;
+    return true;
+}
@@ -0,0 +1,164 @@
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+
+#include <QString>
+#include <QStringList>
+#include <chrono>
+#include <memory>
+#include <opencv2/opencv.hpp>
+
+// 캡처 스레드가 공개하는 한 프레임
+struct CapturedFrame
+{
+    cv::Mat bgr;                                      // 프리뷰용 BGR 프레임(축소 디코드 모드에서는 1/2 크기)
+    cv::Mat jpeg;                                     // 축소 디코드 모드: 원본 MJPEG 비트스트림(1xN 8U)
+    quint64 seq = 0;                                  // 1부터 증가하는 프레임 번호
+    std::chrono::steady_clock::time_point captureTime; // 획득 시각
+    float decodeMs = 0.f;                             // 공급원의 디코드 시간(장치 대기 제외, 없으면 0)
+
+    // 촬영용 원본 해상도 BGR(비트스트림이 있으면 이 시점에 전체 디코드)
+    cv::Mat fullResBGR() const;
+};
+
+/*
+ * 캡처 경로 뒤의 프레임 공급원 인터페이스
+ * - 모든 메서드는 캡처 스레드(또는 벤치마크 루프) 한 곳에서만 호출
+ * - rate > 0이면 read()가 그 속도로 프레임을 내보내고, 0이면 가능한 한 빠르게
+ *
+ * 스펙 문자열(create):
+ *   v4l2[:장치번호]        카메라(기본 0)
+ *   file:경로              동영상 파일(끝나면 처음부터 반복)
+ *   images:디렉터리        이미지 디렉터리(파일명 순, 반복)
+ *   synthetic[:WxH]        결정적 합성 프레임(기본 640x480)
+ *   shm:이름               외부 프로세스의 공유 메모리 프레임 링(유닉스 전용, shmringframesource.h)
+ *   뒤에 @fps를 붙이면 속도 지정(예: synthetic:640x480@30, file:a.mp4@0)
+ */
+class FrameSource
+{
+  public:
+    virtual ~FrameSource() = default;
+
+    virtual bool open() = 0;
+    virtual bool isOpened() const = 0;
+    // 한 프레임을 slot에 채움(bgr 필수, jpeg 선택). seq/captureTime은 호출자가 기록
+    virtual bool read(CapturedFrame &slot) = 0;
+    // 대기 모드 해제 직후 쌓인 오래된 프레임 버리기
+    virtual void drainStale() {}
+    // 고해상도 스틸 한 장(미지원이면 빈 Mat → 호출자가 프리뷰 프레임 사용)
+    virtual cv::Mat grabStill() { return cv::Mat(); }
+    // 프리뷰 구도 기준 크기(스틸 크롭 종횡비)
+    virtual cv::Size frameSize() const = 0;
+    virtual QString describe() const = 0;
+
+    // 출력 속도(fps). 0 = 가능한 한 빠르게
+    void setRate(double fps);
+    double rate() const { return fps_; }
+
+    static std::unique_ptr<FrameSource> create(const QString &spec);
+
+  protected:
+    void pace(); // 다음 프레임 시각까지 대기
+
+  private:
+    double fps_ = 0.0;
+    std::chrono::steady_clock::time_point next_;
+};
+
+/* V4L2(또는 백엔드 자동) 카메라. MJPEG 축소 디코드, 고해상도 스틸 지원 */
+class V4l2FrameSource : public FrameSource
+{
+  public:
+    enum class DecodeMode
+    {
+        Full,        // 드라이버가 매 프레임 전체 해상도 BGR로 디코드
+        ReducedMjpeg // MJPEG 비트스트림을 받아 프리뷰는 1/2 축소 디코드
+    };
+
+    explicit V4l2FrameSource(int device = 0, cv::Size size = cv::Size(640, 480));
+    ~V4l2FrameSource() override;
+
+    // open() 전에 호출
+    void setDecodeMode(DecodeMode mode) { decodeMode_ = mode; }
+    // 빈 Size면 스틸 비활성. stillDevice >= 0이면 스틸 전용 스트림을 미리 열어 둠, 아니면 해상도 전환
+    void setStillResolution(cv::Size size, int stillDevice = -1);
+
+    bool open() override;
+    bool isOpened() const override { return camera_.isOpened(); }
+    bool read(CapturedFrame &slot) override;
+    void drainStale() override;
+    cv::Mat grabStill() override;
+    cv::Size frameSize() const override { return size_; }
+    QString describe() const override;
+
+  private:
+    static void drain(cv::VideoCapture &cap);
+
+    int device_;
+    cv::Size size_;
+    DecodeMode decodeMode_ = DecodeMode::Full;
+    cv::VideoCapture camera_;
+    cv::Mat raw_; // 수신 버퍼
+
+    cv::Size stillSize_;
+    int stillDevice_ = -1;
+    int stillWarmupFrames_ = 3;    // 해상도 전환 직후 노출 안정화용으로 버리는 프레임 수
+    cv::VideoCapture stillCamera_; // 두 번째 스트림(선택)
+};
+
+/* 동영상 파일. 끝에 도달하면 처음으로 되감아 반복 */
+class VideoFileFrameSource : public FrameSource
+{
+  public:
+    explicit VideoFileFrameSource(const QString &path);
+
+    bool open() override;
+    bool isOpened() const override { return cap_.isOpened(); }
+    bool read(CapturedFrame &slot) override;
+    cv::Size frameSize() const override { return size_; }
+    QString describe() const override { return QString("file:%1").arg(path_); }
+
+  private:
+    QString path_;
+    cv::VideoCapture cap_;
+    cv::Size size_;
+};
+
+/* 이미지 디렉터리. 파일명 순서로 반복 재생 */
+class ImageSequenceFrameSource : public FrameSource
+{
+  public:
+    explicit ImageSequenceFrameSource(const QString &dir);
+
+    bool open() override;
+    bool isOpened() const override { return !files_.isEmpty(); }
+    bool read(CapturedFrame &slot) override;
+    cv::Size frameSize() const override { return size_; }
+    QString describe() const override { return QString("images:%1").arg(dir_); }
+
+  private:
+    QString dir_;
+    QStringList files_;
+    int index_ = 0;
+    cv::Size size_;
+};
+
+/* 결정적 합성 프레임: 배경 그라데이션 + 움직이는 얼굴/어깨 + 시드 고정 노이즈 */
+class SyntheticFrameSource : public FrameSource
+{
+  public:
+    explicit SyntheticFrameSource(cv::Size size = cv::Size(640, 480), quint64 seed = 1);
+
+    bool open() override;
+    bool isOpened() const override { return !background_.empty(); }
+    bool read(CapturedFrame &slot) override;
+    cv::Size frameSize() const override { return size_; }
+    QString describe() const override { return QString("synthetic:%1x%2").arg(size_.width).arg(size_.height); }
+
+  private:
+    cv::Size size_;
+    quint64 seed_;
+    quint64 index_ = 0;
+    cv::Mat background_;
+};
+
+#endif // FRAMESOURCE_H
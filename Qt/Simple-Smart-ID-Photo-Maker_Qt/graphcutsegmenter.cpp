@@ -0,0 +1,476 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+// OpenCV modules/imgproc/src/grabcut.cpp(GMM, N-링크 가중치, 그래프 구성)를 옮겨 병렬화/조기 종료를 더한 것
+// 원 저작권/라이선스는 위와 같음
+
+#include "graphcutsegmenter.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
+using namespace cv;
+
+namespace
+{
+constexpr int kComponents = 5;
+constexpr int kModelSize = kComponents * (1 + 3 + 9); // 계수 + 평균 + 공분산
+constexpr double kGamma = 50.0;
+constexpr double kLambda = 9 * kGamma;
+
+double msSince(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// GMM 학습용 표본 누적(스트라이프별로 모은 뒤 합침)
+struct GmmAccum
+{
+    double sums[kComponents][3] = {};
+    double prods[kComponents][3][3] = {};
+    int counts[kComponents] = {};
+
+    void add(int ci, const Vec3d &c)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            sums[ci][i] += c[i];
+            for (int j = 0; j < 3; ++j)
+                prods[ci][i][j] += c[i] * c[j];
+        }
+        ++counts[ci];
+    }
+    void merge(const GmmAccum &o)
+    {
+        for (int ci = 0; ci < kComponents; ++ci)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                sums[ci][i] += o.sums[ci][i];
+                for (int j = 0; j < 3; ++j)
+                    prods[ci][i][j] += o.prods[ci][i][j];
+            }
+            counts[ci] += o.counts[ci];
+        }
+    }
+};
+
+// 모델 Mat(1x65 CV_64F, cv::grabCut과 같은 배치: 계수 5 | 평균 15 | 공분산 45) 위의 GMM
+class Gmm
+{
+  public:
+    explicit Gmm(Mat &model)
+    {
+        if (model.empty())
+        {
+            model.create(1, kModelSize, CV_64FC1);
+            model.setTo(Scalar(0));
+        }
+        CV_Assert(model.type() == CV_64FC1 && model.rows == 1 && model.cols == kModelSize);
+        coefs_ = model.ptr<double>(0);
+        mean_ = coefs_ + kComponents;
+        cov_ = mean_ + 3 * kComponents;
+        for (int ci = 0; ci < kComponents; ++ci)
+            if (coefs_[ci] > 0)
+                calcInverseCovAndDeterm(ci, 0.0);
+    }
+
+    // 성분 ci의 확률 밀도
+    double operator()(int ci, const Vec3d &c) const
+    {
+        if (coefs_[ci] <= 0)
+            return 0.0;
+        const double *m = mean_ + 3 * ci;
+        const double d0 = c[0] - m[0], d1 = c[1] - m[1], d2 = c[2] - m[2];
+        const double(*ic)[3] = inverseCovs_[ci];
+        const double mult = d0 * (d0 * ic[0][0] + d1 * ic[1][0] + d2 * ic[2][0]) + d1 * (d0 * ic[0][1] + d1 * ic[1][1] + d2 * ic[2][1]) + d2 * (d0 * ic[0][2] + d1 * ic[1][2] + d2 * ic[2][2]);
+        return 1.0 / std::sqrt(covDeterms_[ci]) * std::exp(-0.5 * mult);
+    }
+    // 혼합 확률 밀도
+    double operator()(const Vec3d &c) const
+    {
+        double res = 0;
+        for (int ci = 0; ci < kComponents; ++ci)
+            res += coefs_[ci] * (*this)(ci, c);
+        return res;
+    }
+    int whichComponent(const Vec3d &c) const
+    {
+        int k = 0;
+        double best = 0;
+        for (int ci = 0; ci < kComponents; ++ci)
+        {
+            const double p = (*this)(ci, c);
+            if (p > best)
+            {
+                k = ci;
+                best = p;
+            }
+        }
+        return k;
+    }
+
+    // 누적 표본으로 계수/평균/공분산 갱신
+    void learn(const GmmAccum &acc)
+    {
+        int total = 0;
+        for (int ci = 0; ci < kComponents; ++ci)
+            total += acc.counts[ci];
+        for (int ci = 0; ci < kComponents; ++ci)
+        {
+            const int n = acc.counts[ci];
+            if (n == 0)
+            {
+                coefs_[ci] = 0;
+                continue;
+            }
+            const double invN = 1.0 / n;
+            coefs_[ci] = double(n) / total;
+            double *m = mean_ + 3 * ci;
+            for (int i = 0; i < 3; ++i)
+                m[i] = acc.sums[ci][i] * invN;
+            double *c = cov_ + 9 * ci;
+            for (int i = 0; i < 3; ++i)
+                for (int j = 0; j < 3; ++j)
+                    c[i * 3 + j] = acc.prods[ci][i][j] * invN - m[i] * m[j];
+            calcInverseCovAndDeterm(ci, 0.01);
+        }
+    }
+
+  private:
+    // singularFix > 0이면 특이 공분산에 대각 잡음 추가
+    void calcInverseCovAndDeterm(int ci, double singularFix)
+    {
+        double *c = cov_ + 9 * ci;
+        const auto det = [c] { return c[0] * (c[4] * c[8] - c[5] * c[7]) - c[1] * (c[3] * c[8] - c[5] * c[6]) + c[2] * (c[3] * c[7] - c[4] * c[6]); };
+        double dtrm = det();
+        if (dtrm <= 1e-6 && singularFix > 0)
+        {
+            c[0] += singularFix;
+            c[4] += singularFix;
+            c[8] += singularFix;
+            dtrm = det();
+        }
+        covDeterms_[ci] = dtrm;
+        CV_Assert(dtrm > std::numeric_limits<double>::epsilon());
+        const double inv = 1.0 / dtrm;
+        double(*ic)[3] = inverseCovs_[ci];
+        ic[0][0] = (c[4] * c[8] - c[5] * c[7]) * inv;
+        ic[1][0] = -(c[3] * c[8] - c[5] * c[6]) * inv;
+        ic[2][0] = (c[3] * c[7] - c[4] * c[6]) * inv;
+        ic[0][1] = -(c[1] * c[8] - c[2] * c[7]) * inv;
+        ic[1][1] = (c[0] * c[8] - c[2] * c[6]) * inv;
+        ic[2][1] = -(c[0] * c[7] - c[1] * c[6]) * inv;
+        ic[0][2] = (c[1] * c[5] - c[2] * c[4]) * inv;
+        ic[1][2] = -(c[0] * c[5] - c[2] * c[3]) * inv;
+        ic[2][2] = (c[0] * c[4] - c[1] * c[3]) * inv;
+    }
+
+    double *coefs_ = nullptr, *mean_ = nullptr, *cov_ = nullptr;
+    double inverseCovs_[kComponents][3][3] = {};
+    double covDeterms_[kComponents] = {};
+};
+
+inline bool isBackground(uchar m) { return m == GC_BGD || m == GC_PR_BGD; }
+
+// 행을 스트라이프로 나눈 개수(누적 버퍼 수, 코어당 몇 개)
+int stripeCount(int rows) { return std::max(1, std::min(rows, getNumThreads() * 4)); }
+} // namespace
+
+/* 반복 준비: 모델 초기화(필요 시) + 이웃 가중치 계산 */
+void GraphCutSegmenter::begin(const Mat &img, Mat &mask, Mat &bgModel, Mat &fgModel, int mode)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    CV_Assert(img.type() == CV_8UC3 && !img.empty());
+    CV_Assert(mask.type() == CV_8UC1 && mask.size() == img.size());
+    CV_Assert(mode == GC_INIT_WITH_MASK || mode == GC_EVAL);
+    img_ = img;
+    mask_ = &mask;
+    bgModel_ = &bgModel;
+    fgModel_ = &fgModel;
+    stats_ = Stats();
+
+    if (mode == GC_INIT_WITH_MASK)
+        initModels();
+    else
+        CV_Assert(!bgModel.empty() && !fgModel.empty());
+    computeNWeights();
+    stats_.ms = msSince(t0);
+}
+
+/* 트라이맵 배경/전경 표본을 k-means로 나눠 초기 GMM 학습(cv::grabCut과 같은 방식) */
+void GraphCutSegmenter::initModels()
+{
+    std::vector<Vec3f> bgSamples, fgSamples;
+    for (int y = 0; y < img_.rows; ++y)
+    {
+        const Vec3b *p = img_.ptr<Vec3b>(y);
+        const uchar *m = mask_->ptr<uchar>(y);
+        for (int x = 0; x < img_.cols; ++x)
+            (isBackground(m[x]) ? bgSamples : fgSamples).push_back(Vec3f(p[x]));
+    }
+    CV_Assert(!bgSamples.empty() && !fgSamples.empty());
+
+    const TermCriteria crit(TermCriteria::MAX_ITER, 10, 0.0);
+    const auto learn = [&](std::vector<Vec3f> &samples, Mat &model) {
+        Mat labels;
+        kmeans(Mat(int(samples.size()), 3, CV_32FC1, &samples[0][0]), kComponents, labels, crit, 0, KMEANS_PP_CENTERS);
+        GmmAccum acc;
+        for (int i = 0; i < int(samples.size()); ++i)
+            acc.add(labels.at<int>(i), Vec3d(samples[i]));
+        model.release();
+        Gmm(model).learn(acc);
+    };
+    learn(bgSamples, *bgModel_);
+    learn(fgSamples, *fgModel_);
+}
+
+/* 이웃 간선 가중치: gamma * exp(-beta * |색 차|²), 대각선은 /sqrt(2). 행 병렬 */
+void GraphCutSegmenter::computeNWeights()
+{
+    const int rows = img_.rows, cols = img_.cols;
+    const auto sq = [](const Vec3b &a, const Vec3b &b) {
+        const double d0 = double(a[0]) - b[0], d1 = double(a[1]) - b[1], d2 = double(a[2]) - b[2];
+        return d0 * d0 + d1 * d1 + d2 * d2;
+    };
+
+    // beta = 1 / (2 * 평균 색 차²)
+    std::vector<double> rowSums(rows, 0.0);
+    parallel_for_(Range(0, rows), [&](const Range &r) {
+        for (int y = r.start; y < r.end; ++y)
+        {
+            const Vec3b *p = img_.ptr<Vec3b>(y);
+            const Vec3b *up = y > 0 ? img_.ptr<Vec3b>(y - 1) : nullptr;
+            double s = 0;
+            for (int x = 0; x < cols; ++x)
+            {
+                if (x > 0)
+                    s += sq(p[x], p[x - 1]);
+                if (up)
+                {
+                    if (x > 0)
+                        s += sq(p[x], up[x - 1]);
+                    s += sq(p[x], up[x]);
+                    if (x < cols - 1)
+                        s += sq(p[x], up[x + 1]);
+                }
+            }
+            rowSums[y] = s;
+        }
+    });
+    double beta = 0;
+    for (double s : rowSums)
+        beta += s;
+    if (beta <= std::numeric_limits<double>::epsilon())
+        beta = 0;
+    else
+        beta = 1.0 / (2 * beta / (4.0 * cols * rows - 3.0 * cols - 3.0 * rows + 2));
+
+    const double gammaDivSqrt2 = kGamma / std::sqrt(2.0);
+    leftW_.create(rows, cols, CV_64FC1);
+    upleftW_.create(rows, cols, CV_64FC1);
+    upW_.create(rows, cols, CV_64FC1);
+    uprightW_.create(rows, cols, CV_64FC1);
+    parallel_for_(Range(0, rows), [&](const Range &r) {
+        for (int y = r.start; y < r.end; ++y)
+        {
+            const Vec3b *p = img_.ptr<Vec3b>(y);
+            const Vec3b *up = y > 0 ? img_.ptr<Vec3b>(y - 1) : nullptr;
+            double *l = leftW_.ptr<double>(y), *ul = upleftW_.ptr<double>(y);
+            double *u = upW_.ptr<double>(y), *ur = uprightW_.ptr<double>(y);
+            for (int x = 0; x < cols; ++x)
+            {
+                l[x] = x > 0 ? kGamma * std::exp(-beta * sq(p[x], p[x - 1])) : 0;
+                ul[x] = up && x > 0 ? gammaDivSqrt2 * std::exp(-beta * sq(p[x], up[x - 1])) : 0;
+                u[x] = up ? kGamma * std::exp(-beta * sq(p[x], up[x])) : 0;
+                ur[x] = up && x < cols - 1 ? gammaDivSqrt2 * std::exp(-beta * sq(p[x], up[x + 1])) : 0;
+            }
+        }
+    });
+}
+
+/* 한 번 반복: 성분 할당+학습(병렬) → 터미널 가중치(병렬) → 그래프 컷 → 추정 라벨 갱신 */
+bool GraphCutSegmenter::iterate()
+{
+    CV_Assert(mask_ && bgModel_ && fgModel_);
+    const auto t0 = std::chrono::steady_clock::now();
+    const int rows = img_.rows, cols = img_.cols;
+
+    // 1) 현재 모델로 성분 할당하면서 바로 표본 누적(스트라이프별 → 순서대로 합쳐 결과 결정적)
+    Gmm bgGmm(*bgModel_), fgGmm(*fgModel_);
+    const int stripes = stripeCount(rows);
+    std::vector<GmmAccum> bgAcc(stripes), fgAcc(stripes);
+    parallel_for_(Range(0, stripes), [&](const Range &r) {
+        for (int s = r.start; s < r.end; ++s)
+        {
+            for (int y = rows * s / stripes, y1 = rows * (s + 1) / stripes; y < y1; ++y)
+            {
+                const Vec3b *p = img_.ptr<Vec3b>(y);
+                const uchar *m = mask_->ptr<uchar>(y);
+                for (int x = 0; x < cols; ++x)
+                {
+                    const Vec3d c(p[x]);
+                    if (isBackground(m[x]))
+                        bgAcc[s].add(bgGmm.whichComponent(c), c);
+                    else
+                        fgAcc[s].add(fgGmm.whichComponent(c), c);
+                }
+            }
+        }
+    });
+    for (int s = 1; s < stripes; ++s)
+    {
+        bgAcc[0].merge(bgAcc[s]);
+        fgAcc[0].merge(fgAcc[s]);
+    }
+    bgGmm.learn(bgAcc[0]);
+    fgGmm.learn(fgAcc[0]);
+
+    // 2) 터미널 가중치: 추정 픽셀은 -log(확률), 확정 픽셀은 lambda
+    sourceW_.create(rows, cols, CV_64FC1);
+    sinkW_.create(rows, cols, CV_64FC1);
+    parallel_for_(Range(0, rows), [&](const Range &r) {
+        for (int y = r.start; y < r.end; ++y)
+        {
+            const Vec3b *p = img_.ptr<Vec3b>(y);
+            const uchar *m = mask_->ptr<uchar>(y);
+            double *src = sourceW_.ptr<double>(y), *snk = sinkW_.ptr<double>(y);
+            for (int x = 0; x < cols; ++x)
+            {
+                if (m[x] == GC_PR_BGD || m[x] == GC_PR_FGD)
+                {
+                    const Vec3d c(p[x]);
+                    src[x] = -std::log(std::max(bgGmm(c), DBL_MIN));
+                    snk[x] = -std::log(std::max(fgGmm(c), DBL_MIN));
+                }
+                else
+                {
+                    src[x] = m[x] == GC_BGD ? 0 : kLambda;
+                    snk[x] = m[x] == GC_BGD ? kLambda : 0;
+                }
+            }
+        }
+    });
+
+    // 3) 그래프 구성(메모리 재사용) + 최대 유량
+    buildGraph();
+    graph_.maxFlow();
+
+    // 4) 추정 라벨 갱신 + 변화 비율
+    int changed = 0, unknown = 0;
+    for (int y = 0, v = 0; y < rows; ++y)
+    {
+        uchar *m = mask_->ptr<uchar>(y);
+        for (int x = 0; x < cols; ++x, ++v)
+        {
+            if (m[x] != GC_PR_BGD && m[x] != GC_PR_FGD)
+                continue;
+            ++unknown;
+            const uchar label = graph_.inSourceSegment(v) ? GC_PR_FGD : GC_PR_BGD;
+            if (label != m[x])
+            {
+                ++changed;
+                m[x] = label;
+            }
+        }
+    }
+
+    stats_.iterations++;
+    stats_.changedRatio = unknown > 0 ? double(changed) / unknown : 0.0;
+    stats_.ms += msSince(t0);
+    return stats_.changedRatio < convergence_;
+}
+
+/* 픽셀당 정점 1개 + 좌/좌상/상/우상 간선(양방향 같은 가중치) */
+void GraphCutSegmenter::buildGraph()
+{
+    const int rows = img_.rows, cols = img_.cols;
+    graph_.reset(size_t(rows) * cols, size_t(2) * (4 * size_t(rows) * cols - 3 * (cols + rows) + 2));
+    for (int y = 0; y < rows; ++y)
+    {
+        const double *src = sourceW_.ptr<double>(y), *snk = sinkW_.ptr<double>(y);
+        const double *l = leftW_.ptr<double>(y), *ul = upleftW_.ptr<double>(y);
+        const double *u = upW_.ptr<double>(y), *ur = uprightW_.ptr<double>(y);
+        for (int x = 0; x < cols; ++x)
+        {
+            const int v = graph_.addVtx();
+            graph_.addTermWeights(v, src[x], snk[x]);
+            if (x > 0)
+                graph_.addEdges(v, v - 1, l[x], l[x]);
+            if (y > 0)
+            {
+                if (x > 0)
+                    graph_.addEdges(v, v - cols - 1, ul[x], ul[x]);
+                graph_.addEdges(v, v - cols, u[x], u[x]);
+                if (x < cols - 1)
+                    graph_.addEdges(v, v - cols + 1, ur[x], ur[x]);
+            }
+        }
+    }
+}
+
+/* 칸 중심 색마다 fg / (fg + bg) (두 모델 사전 확률 동일). 파란 성분 단위로 병렬 */
+Mat GraphCutSegmenter::bakeForegroundLut(const Mat &bgModel, const Mat &fgModel, int bits)
+{
+    CV_Assert(bits >= 1 && bits <= 8);
+    Mat bgCopy = bgModel.clone(), fgCopy = fgModel.clone(); // Gmm은 모델 Mat을 수정 가능하게 받음
+    const Gmm bgGmm(bgCopy), fgGmm(fgCopy);
+    const int bins = 1 << bits, shift = 8 - bits;
+    const double center = (1 << shift) * 0.5 - 0.5;
+    Mat lut(1, bins * bins * bins, CV_8U);
+    parallel_for_(Range(0, bins), [&](const Range &r) {
+        for (int b = r.start; b < r.end; ++b)
+        {
+            uchar *d = lut.ptr<uchar>() + b * bins * bins;
+            for (int g = 0; g < bins; ++g)
+                for (int rr = 0; rr < bins; ++rr)
+                {
+                    const Vec3d c((b << shift) + center, (g << shift) + center, (rr << shift) + center);
+                    const double pf = fgGmm(c), pb = bgGmm(c);
+                    const double sum = pf + pb;
+                    *d++ = sum > 0 ? saturate_cast<uchar>(255.0 * pf / sum) : 0;
+                }
+        }
+    });
+    return lut;
+}
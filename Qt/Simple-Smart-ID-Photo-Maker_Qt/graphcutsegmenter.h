@@ -0,0 +1,55 @@
+#ifndef GRAPHCUTSEGMENTER_H
+#define GRAPHCUTSEGMENTER_H
+
+#include "flowgraph.h"
+#include <opencv2/opencv.hpp>
+
+/*
+ * cv::grabCut 대체 엔진(같은 마스크 값, 같은 1x65 CV_64F 색 모델 배치 → 서로 이어서 사용 가능)
+ * - GMM 성분 할당/학습, 터미널 가중치 계산은 행 단위 병렬(cv::parallel_for_)
+ * - 이웃 가중치는 begin()에서 한 번, 그래프 메모리는 반복/호출 간 재사용
+ * - 추정 라벨 변화 비율이 수렴 기준 미만이면 iterate()가 true → 호출자가 조기 종료
+ * 한 객체는 한 스레드에서만 사용. begin()에 넘긴 마스크/모델은 반복이 끝날 때까지 유지해야 함
+ */
+class GraphCutSegmenter
+{
+  public:
+    struct Stats
+    {
+        int iterations = 0;        // begin() 이후 수행한 반복 수
+        double changedRatio = 1.0; // 마지막 반복에서 라벨이 바뀐 추정 픽셀 비율
+        double ms = 0.0;           // begin() 포함 누적 시간
+    };
+
+    // 수렴 기준(추정 픽셀 중 라벨이 바뀐 비율, 기본 0.1%)
+    void setConvergence(double ratio) { convergence_ = ratio; }
+    double convergence() const { return convergence_; }
+
+    // mode: GC_INIT_WITH_MASK(트라이맵으로 모델 학습) 또는 GC_EVAL(bgModel/fgModel에서 시작)
+    void begin(const cv::Mat &img, cv::Mat &mask, cv::Mat &bgModel, cv::Mat &fgModel, int mode);
+    // 한 번 반복(할당 → 학습 → 그래프 컷 → 마스크 갱신). 수렴했으면 true
+    bool iterate();
+    const Stats &stats() const { return stats_; }
+
+    // 색 모델로 전경 확률 표 생성: (2^bits)³ 칸, 인덱스 ((B>>s)<<2bits)|((G>>s)<<bits)|(R>>s) (s = 8-bits), 값 0~255
+    static cv::Mat bakeForegroundLut(const cv::Mat &bgModel, const cv::Mat &fgModel, int bits = 5);
+
+  private:
+    void initModels();
+    void computeNWeights();
+    void buildGraph();
+
+    cv::Mat img_;
+    cv::Mat *mask_ = nullptr;
+    cv::Mat *bgModel_ = nullptr;
+    cv::Mat *fgModel_ = nullptr;
+
+    cv::Mat leftW_, upleftW_, upW_, uprightW_; // 이웃 간선 가중치(CV_64F)
+    cv::Mat sourceW_, sinkW_;                  // 터미널 가중치(CV_64F)
+    FlowGraph<double> graph_;
+
+    double convergence_ = 0.001;
+    Stats stats_;
+};
+
+#endif // GRAPHCUTSEGMENTER_H
@@ -0,0 +1,152 @@
+#include "guidedfilter.h"
+#include <opencv2/core/hal/intrin.hpp>
+using namespace cv;
+
+namespace
+{
+/* 1단계 한 행: 4채널 (I, p, I², I·p), 0~1 스케일 */
+void prepareRow(const uchar *guide, const uchar *src, float *out, int n)
+{
+    const float k = 1.f / 255;
+    int x = 0;
+#if CV_SIMD128
+    const v_float32x4 vk = v_setall_f32(k);
+    for (; x <= n - 4; x += 4)
+    {
+        const v_float32x4 I = v_cvt_f32(v_reinterpret_as_s32(v_load_expand_q(guide + x))) * vk;
+        const v_float32x4 p = v_cvt_f32(v_reinterpret_as_s32(v_load_expand_q(src + x))) * vk;
+        v_store_interleave(out + 4 * x, I, p, I * I, I * p);
+    }
+#endif
+    for (; x < n; ++x)
+    {
+        const float I = guide[x] * k, p = src[x] * k;
+        float *o = out + 4 * x;
+        o[0] = I;
+        o[1] = p;
+        o[2] = I * I;
+        o[3] = I * p;
+    }
+}
+
+/* 2단계 한 행: 창 평균 4채널 → 선형 계수 a = cov(I,p)/(var(I)+eps), b = mean(p) - a·mean(I) */
+void coefficientRow(const float *means, float *ab, int n, float eps)
+{
+    int x = 0;
+#if CV_SIMD128
+    const v_float32x4 veps = v_setall_f32(eps);
+    for (; x <= n - 4; x += 4)
+    {
+        v_float32x4 mI, mp, mII, mIp;
+        v_load_deinterleave(means + 4 * x, mI, mp, mII, mIp);
+        const v_float32x4 a = (mIp - mI * mp) / (mII - mI * mI + veps);
+        v_store_interleave(ab + 2 * x, a, mp - a * mI);
+    }
+#endif
+    for (; x < n; ++x)
+    {
+        const float *m = means + 4 * x;
+        const float a = (m[3] - m[0] * m[1]) / (m[2] - m[0] * m[0] + eps);
+        ab[2 * x] = a;
+        ab[2 * x + 1] = m[1] - a * m[0];
+    }
+}
+
+/* 3단계 한 행: q = mean(a)·I + mean(b) → 0~255 반올림/포화 */
+void outputRow(const float *ab, const uchar *guide, uchar *out, int n)
+{
+    int x = 0;
+#if CV_SIMD128
+    const v_float32x4 v255 = v_setall_f32(255.f);
+    for (; x <= n - 8; x += 8)
+    {
+        v_float32x4 a0, b0, a1, b1;
+        v_load_deinterleave(ab + 2 * x, a0, b0);
+        v_load_deinterleave(ab + 2 * x + 8, a1, b1);
+        const v_float32x4 i0 = v_cvt_f32(v_reinterpret_as_s32(v_load_expand_q(guide + x)));
+        const v_float32x4 i1 = v_cvt_f32(v_reinterpret_as_s32(v_load_expand_q(guide + x + 4)));
+        // a는 0~1 스케일 계수라 255 스케일 I에 그대로 곱하고 b만 255배
+        v_pack_u_store(out + x, v_pack(v_round(v_fma(a0, i0, b0 * v255)), v_round(v_fma(a1, i1, b1 * v255))));
+    }
+#endif
+    for (; x < n; ++x)
+        out[x] = saturate_cast<uchar>(ab[2 * x] * guide[x] + ab[2 * x + 1] * 255.f);
+}
+} // namespace
+
+/* 계수는 src 해상도에서 구하고(창 평균 두 번), 출력은 guide 해상도에서 */
+Mat GuidedFilter::filter(const Mat &guide, const Mat &src, int radius, double eps)
+{
+    CV_Assert(src.type() == CV_8UC1 && !src.empty() && radius >= 1);
+    Mat gray;
+    if (guide.channels() == 3)
+        cvtColor(guide, gray, COLOR_BGR2GRAY);
+    else
+        gray = guide;
+    CV_Assert(gray.type() == CV_8UC1);
+
+    Mat lowGuide = gray;
+    int r = radius;
+    if (src.size() != gray.size())
+    {
+        resize(gray, lowGuide, src.size(), 0, 0, INTER_AREA);
+        r = std::max(1, int(std::lround(radius * double(src.cols) / gray.cols)));
+    }
+    const Size win(2 * r + 1, 2 * r + 1);
+    const int rows = src.rows, cols = src.cols;
+
+    Mat stats(src.size(), CV_32FC4), means;
+    parallel_for_(Range(0, rows), [&](const Range &rr) {
+        for (int y = rr.start; y < rr.end; ++y)
+            prepareRow(lowGuide.ptr<uchar>(y), src.ptr<uchar>(y), stats.ptr<float>(y), cols);
+    });
+    boxFilter(stats, means, -1, win, Point(-1, -1), true, BORDER_REFLECT);
+
+    Mat ab(src.size(), CV_32FC2), meanAB;
+    parallel_for_(Range(0, rows), [&](const Range &rr) {
+        for (int y = rr.start; y < rr.end; ++y)
+            coefficientRow(means.ptr<float>(y), ab.ptr<float>(y), cols, float(eps));
+    });
+    boxFilter(ab, meanAB, -1, win, Point(-1, -1), true, BORDER_REFLECT);
+    if (meanAB.size() != gray.size())
+        resize(meanAB, meanAB, gray.size(), 0, 0, INTER_LINEAR);
+
+    Mat out(gray.size(), CV_8UC1);
+    parallel_for_(Range(0, gray.rows), [&](const Range &rr) {
+        for (int y = rr.start; y < rr.end; ++y)
+            outputRow(meanAB.ptr<float>(y), gray.ptr<uchar>(y), out.ptr<uchar>(y), gray.cols);
+    });
+    return out;
+}
+
+/* 초크 → 전경 근처 ROI만 1/2 해상도 계수로 필터(창 평균 두 번이 비용 대부분이라 면적을 줄임) */
+Mat GuidedFilter::refineMatte(const Mat &guide, const Mat &alpha, int radius, double eps)
+{
+    CV_Assert(alpha.type() == CV_8UC1 && !alpha.empty() && radius >= 1);
+    Mat gray;
+    if (guide.channels() == 3)
+        cvtColor(guide, gray, COLOR_BGR2GRAY);
+    else
+        gray = guide;
+    CV_Assert(gray.type() == CV_8UC1);
+
+    Mat choked;
+    erode(alpha, choked, Mat()); // 3x3
+    Mat out = Mat::zeros(gray.size(), CV_8UC1);
+    const Rect box = boundingRect(choked);
+    if (box.empty())
+        return out;
+
+    // 계수 창(r) + 계수 평균 창(r) 밖은 상수라 그대로 0, 1/2 해상도 반올림 몫으로 2픽셀 더
+    const int pad = 2 * radius + 2;
+    const Rect roi = Rect(box.x - pad, box.y - pad, box.width + 2 * pad, box.height + 2 * pad) & Rect(Point(), alpha.size());
+    const double sx = double(gray.cols) / alpha.cols, sy = double(gray.rows) / alpha.rows;
+    const int gx0 = int(std::lround(roi.x * sx)), gy0 = int(std::lround(roi.y * sy));
+    const int gx1 = std::min(gray.cols, int(std::lround(roi.br().x * sx))), gy1 = std::min(gray.rows, int(std::lround(roi.br().y * sy)));
+    const Rect groi(gx0, gy0, gx1 - gx0, gy1 - gy0);
+
+    Mat low;
+    resize(choked(roi), low, Size(std::max(1, (roi.width + 1) / 2), std::max(1, (roi.height + 1) / 2)), 0, 0, INTER_AREA);
+    filter(gray(groi), low, std::max(1, int(std::lround(radius * sx))), eps).copyTo(out(groi));
+    return out;
+}
@@ -0,0 +1,24 @@
+#ifndef GUIDEDFILTER_H
+#define GUIDEDFILTER_H
+
+#include <opencv2/opencv.hpp>
+
+/*
+ * 가이드 필터(He et al.) 알파 정제: 창 평균은 cv::boxFilter(반경과 무관한 O(N)),
+ * 원소별 단계는 행 병렬 SIMD. 가이드는 밝기(BGR이면 회색으로 변환)
+ * - src와 guide 크기가 같으면 일반 가이드 필터
+ * - src가 더 작으면 src 해상도에서 선형 계수를 구해 guide 해상도로 올려 적용(가이드 업샘플)
+ */
+namespace GuidedFilter
+{
+// radius: guide 해상도 기준 창 반경, eps: 0~1 스케일 정규화 항(클수록 더 부드러움). 결과는 guide 크기 8UC1
+cv::Mat filter(const cv::Mat &guide, const cv::Mat &src, int radius, double eps);
+
+// 이진 매트(0/255) 경계 정리용. 한 픽셀 초크(3x3 침식, 배경색 테두리 제거) 후
+// 전경 외접 사각형 + 2*radius 여백 안에서만, 계수는 그 1/2 해상도로 filter(). 밖은 0
+// (상수 영역에서는 필터 결과가 입력과 같으므로 여백 밖을 건너뛰어도 결과가 같음)
+// radius: alpha 해상도 기준. 결과는 guide 크기 8UC1(guide가 더 크면 업샘플)
+cv::Mat refineMatte(const cv::Mat &guide, const cv::Mat &alpha, int radius, double eps);
+} // namespace GuidedFilter
+
+#endif // GUIDEDFILTER_H
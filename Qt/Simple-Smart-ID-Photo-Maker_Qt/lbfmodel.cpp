@@ -0,0 +1,406 @@
+#include "lbfmodel.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+using namespace cv;
+
+struct LbfModel::Header
+{
+    char magic[8];      // "IDPLBF\0\0"
+    quint32 version;    // kVersion
+    quint32 byteOrder;  // 0x01020304(쓴 장비와 엔디언이 다르면 거부)
+    quint32 stages;     // S
+    quint32 landmarks;  // L
+    quint32 trees;      // T
+    quint32 depth;      // 트리 깊이(N = 2^(depth-1))
+    quint64 meanShapeOffset;
+    quint64 featsOffset;
+    quint64 thresholdsOffset;
+    quint64 weightsOffset;
+    quint64 fileSize;
+};
+
+namespace
+{
+const char kMagic[8] = {'I', 'D', 'P', 'L', 'B', 'F', 0, 0};
+constexpr quint32 kVersion = 1;
+constexpr quint32 kByteOrder = 0x01020304;
+constexpr quint64 kAlign = 64;
+
+quint64 alignUp(quint64 v) { return (v + kAlign - 1) & ~(kAlign - 1); }
+
+// 구역 크기(개수)
+struct Layout
+{
+    quint64 nodes, meanShape, feats, thresholds, weightRows, weightCols;
+    Layout(quint32 s, quint32 l, quint32 t, quint32 d)
+        : nodes(quint64(1) << (d - 1)), meanShape(quint64(l) * 2), feats(quint64(s) * l * t * nodes * 4), thresholds(quint64(s) * l * t * nodes), weightRows(quint64(l) * t * nodes), weightCols(quint64(l) * 2)
+    {
+    }
+};
+} // namespace
+
+/* shape1 → shape2 유사 변환의 배율/회전(FacemarkLBF calcSimilarityTransform과 같은 계산) */
+static void similarityTransform(const Mat &shape1, const Mat &shape2, double &scale, Matx22d &rotate)
+{
+    Mat t1 = shape1.clone(), t2 = shape2.clone();
+    for (int c = 0; c < 2; ++c)
+    {
+        Mat c1 = t1.col(c), c2 = t2.col(c);
+        c1 -= mean(c1)[0];
+        c2 -= mean(c2)[0];
+    }
+    Mat covar1, covar2, mean1, mean2;
+    calcCovarMatrix(t1, covar1, mean1, COVAR_COLS);
+    calcCovarMatrix(t2, covar2, mean2, COVAR_COLS);
+    const double s1 = std::sqrt(norm(covar1)), s2 = std::sqrt(norm(covar2));
+    scale = s1 / s2;
+    t1 /= s1;
+    t2 /= s2;
+    const double num = t1.col(1).dot(t2.col(0)) - t1.col(0).dot(t2.col(1));
+    const double den = t1.col(0).dot(t2.col(0)) + t1.col(1).dot(t2.col(1));
+    const double normed = std::sqrt(num * num + den * den);
+    const double sinT = num / normed, cosT = den / normed;
+    rotate = Matx22d(cosT, -sinT, sinT, cosT);
+}
+
+LbfModel::~LbfModel()
+{
+    if (header_)
+        file_.unmap(reinterpret_cast<uchar *>(const_cast<Header *>(header_)));
+}
+
+int LbfModel::landmarkCount() const { return header_ ? int(header_->landmarks) : 0; }
+
+/* 헤더 검증 후 구역 포인터만 설정(파싱 없음) */
+bool LbfModel::map(const QString &binPath)
+{
+    file_.setFileName(binPath);
+    if (!file_.open(QIODevice::ReadOnly) || file_.size() < qint64(sizeof(Header)))
+        return false;
+    const uchar *base = file_.map(0, file_.size());
+    if (!base)
+        return false;
+    const Header *h = reinterpret_cast<const Header *>(base);
+    bool ok = std::memcmp(h->magic, kMagic, sizeof(kMagic)) == 0 && h->version == kVersion && h->byteOrder == kByteOrder && h->fileSize == quint64(file_.size());
+    ok = ok && h->stages > 0 && h->landmarks > 0 && h->trees > 0 && h->depth >= 2 && h->depth <= 16;
+    if (ok)
+    {
+        const Layout n(h->stages, h->landmarks, h->trees, h->depth);
+        ok = h->meanShapeOffset + n.meanShape * sizeof(float) <= h->fileSize && h->featsOffset + n.feats * sizeof(float) <= h->fileSize && h->thresholdsOffset + n.thresholds * sizeof(qint16) <= h->fileSize &&
+             h->weightsOffset + quint64(h->stages) * n.weightRows * n.weightCols * sizeof(float) <= h->fileSize;
+    }
+    if (!ok)
+    {
+        file_.unmap(const_cast<uchar *>(base));
+        file_.close();
+        return false;
+    }
+    header_ = h;
+    meanShape_ = reinterpret_cast<const float *>(base + h->meanShapeOffset);
+    feats_ = reinterpret_cast<const float *>(base + h->featsOffset);
+    thresholds_ = reinterpret_cast<const qint16 *>(base + h->thresholdsOffset);
+    weights_ = reinterpret_cast<const float *>(base + h->weightsOffset);
+    Mat(int(h->landmarks), 2, CV_32F, const_cast<float *>(meanShape_)).convertTo(meanShapeD_, CV_64F);
+    return true;
+}
+
+Ptr<LbfModel> LbfModel::open(const QString &binPath)
+{
+    Ptr<LbfModel> m = makePtr<LbfModel>();
+    return m->map(binPath) ? m : nullptr;
+}
+
+void LbfModel::loadModel(String model)
+{
+    if (header_ || !map(QString::fromStdString(model)))
+        CV_Error(Error::StsBadArg, "LbfModel: cannot map " + model);
+}
+
+bool LbfModel::fit(InputArray image, InputArray faces, OutputArrayOfArrays landmarks)
+{
+    Mat gray = image.getMat();
+    if (gray.channels() > 1)
+        cvtColor(gray, gray, COLOR_BGR2GRAY);
+    const Mat rects = faces.getMat();
+    std::vector<Rect> boxes = rects.reshape(4, rects.rows);
+    if (boxes.empty())
+        return false;
+    // 출력은 OutputArrayOfArrays 규약대로(vector<vector<Point2f>>, vector<Mat> 등 어느 형태든 얼굴마다 Nx1 CV_32FC2)
+    landmarks.create(int(boxes.size()), 1, CV_32FC2);
+    bool ok = true;
+    std::vector<Point2f> shape;
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+        ok = fitFace(gray, boxes[i], shape) && ok;
+        landmarks.create(int(shape.size()), 1, CV_32FC2, int(i));
+        if (!shape.empty())
+        {
+            Mat dst = landmarks.getMat(int(i));
+            Mat(shape).copyTo(dst);
+        }
+    }
+    return ok;
+}
+
+/* 얼굴 주변(사방 반 폭) 영역에서 단계별로: 유사 변환 → 트리 잎 인덱스(LBF) → 가중치 합으로 형상 갱신 */
+bool LbfModel::fitFace(const Mat &gray, const Rect &box, std::vector<Point2f> &landmarks) const
+{
+    landmarks.clear();
+    if (!header_ || gray.type() != CV_8UC1 || box.width <= 0 || box.height <= 0)
+        return false;
+
+    const double minX = std::max(0., double(box.x) - box.width / 2);
+    const double maxX = std::min(gray.cols - 1., double(box.x + box.width + box.width / 2));
+    const double minY = std::max(0., double(box.y) - box.height / 2);
+    const double maxY = std::min(gray.rows - 1., double(box.y + box.height + box.height / 2));
+    if (maxX - minX < 1 || maxY - minY < 1)
+        return false;
+    const Mat crop = gray(Rect(int(minX), int(minY), int(maxX - minX), int(maxY - minY)));
+
+    // 얼굴 사각형 정규화 좌표(중심 0, 반 폭 1)
+    const double bx = box.x - minX, by = box.y - minY;
+    const double xScale = box.width / 2., yScale = box.height / 2.;
+    const double xCenter = bx + xScale, yCenter = by + yScale;
+
+    const int S = int(header_->stages), L = int(header_->landmarks), T = int(header_->trees), D = int(header_->depth);
+    const Layout n(header_->stages, header_->landmarks, header_->trees, header_->depth);
+    const double maxCol = crop.cols - 1., maxRow = crop.rows - 1.;
+
+    Mat proj = meanShapeD_.clone(); // 정규화 좌표 형상(평균 형상에서 시작)
+    std::vector<double> shape(size_t(L) * 2);
+    for (int i = 0; i < L; ++i)
+    {
+        shape[2 * i] = proj.at<double>(i, 0) * xScale + xCenter;
+        shape[2 * i + 1] = proj.at<double>(i, 1) * yScale + yCenter;
+    }
+    std::vector<float> delta(n.weightCols);
+
+    for (int k = 0; k < S; ++k)
+    {
+        double scale;
+        Matx22d R;
+        similarityTransform(proj, meanShapeD_, scale, R);
+
+        std::fill(delta.begin(), delta.end(), 0.f);
+        const float *W = weights_ + quint64(k) * n.weightRows * n.weightCols;
+        for (int i = 0; i < L; ++i)
+        {
+            const double cx = shape[2 * i], cy = shape[2 * i + 1];
+            for (int j = 0; j < T; ++j)
+            {
+                const quint64 tree = (quint64(k) * L + i) * T + j;
+                const float *F = feats_ + tree * n.nodes * 4;
+                const qint16 *th = thresholds_ + tree * n.nodes;
+                int code = 0, node = 1;
+                for (int d = 1; d < D; ++d)
+                {
+                    const float *f = F + node * 4;
+                    const double x1 = std::clamp(scale * (R(0, 0) * f[0] + R(0, 1) * f[1]) * xScale + cx, 0., maxCol);
+                    const double y1 = std::clamp(scale * (R(1, 0) * f[0] + R(1, 1) * f[1]) * yScale + cy, 0., maxRow);
+                    const double x2 = std::clamp(scale * (R(0, 0) * f[2] + R(0, 1) * f[3]) * xScale + cx, 0., maxCol);
+                    const double y2 = std::clamp(scale * (R(1, 0) * f[2] + R(1, 1) * f[3]) * yScale + cy, 0., maxRow);
+                    const int density = int(crop.at<uchar>(int(y1), int(x1))) - int(crop.at<uchar>(int(y2), int(x2)));
+                    code <<= 1;
+                    if (density < th[node])
+                        node = 2 * node;
+                    else
+                    {
+                        code += 1;
+                        node = 2 * node + 1;
+                    }
+                }
+                // 이 트리의 잎 → 가중치 한 줄(L*2)을 누적
+                const float *w = W + (quint64(i * T + j) * n.nodes + code) * n.weightCols;
+                for (quint64 c = 0; c < n.weightCols; ++c)
+                    delta[c] += w[c];
+            }
+        }
+
+        // 정규화 좌표(proj)에서 (delta x 회전^T) x 배율만큼 이동 후 다시 이미지 좌표로
+        for (int i = 0; i < L; ++i)
+        {
+            const double dx = delta[2 * i], dy = delta[2 * i + 1];
+            double &px = proj.at<double>(i, 0), &py = proj.at<double>(i, 1);
+            px += scale * (dx * R(0, 0) + dy * R(0, 1));
+            py += scale * (dx * R(1, 0) + dy * R(1, 1));
+            shape[2 * i] = px * xScale + xCenter;
+            shape[2 * i + 1] = py * yScale + yCenter;
+        }
+    }
+
+    landmarks.resize(L);
+    for (int i = 0; i < L; ++i)
+        landmarks[i] = Point2f(float(shape[2 * i] + minX), float(shape[2 * i + 1] + minY));
+    return true;
+}
+
+/* 정수 배열 노드(시퀀스 또는 행렬 저장 모두) */
+static std::vector<int> readInts(const FileNode &node)
+{
+    std::vector<int> v;
+    if (node.isSeq())
+        node >> v;
+    else if (!node.empty())
+    {
+        Mat m;
+        node >> m;
+        m.reshape(1, 1).convertTo(v, CV_32S);
+    }
+    return v;
+}
+
+/* 변환 결과를 FacemarkLBF와 비교(무작위 질감 영상 몇 장, 평균 점 오차 px) */
+static double compareWithReference(const QString &yamlPath, LbfModel &model)
+{
+    Ptr<face::FacemarkLBF> ref = face::FacemarkLBF::create();
+    ref->loadModel(yamlPath.toStdString());
+    RNG rng(0x1d9407);
+    double sum = 0.;
+    int count = 0;
+    for (int t = 0; t < 4; ++t)
+    {
+        Mat img(480, 480, CV_8UC1);
+        rng.fill(img, RNG::UNIFORM, 0, 256);
+        GaussianBlur(img, img, Size(0, 0), 3.0 + t);
+        const std::vector<Rect> faces = {Rect(120 + 10 * t, 110, 220 - 15 * t, 220 - 15 * t)};
+        std::vector<std::vector<Point2f>> a, b;
+        if (!ref->fit(img, faces, a) || !model.fit(img, faces, b) || a.empty() || b.empty() || a[0].size() != b[0].size())
+            return -1.;
+        for (size_t i = 0; i < a[0].size(); ++i)
+            sum += norm(a[0][i] - b[0][i]);
+        count += int(a[0].size());
+    }
+    return count ? sum / count : -1.;
+}
+
+bool LbfModel::convert(const QString &yamlPath, const QString &binPath, QString *error)
+{
+    auto fail = [error](const QString &why) {
+        if (error)
+            *error = why;
+        return false;
+    };
+    QElapsedTimer t;
+    t.start();
+
+    FileStorage fs;
+    try
+    {
+        fs.open(yamlPath.toStdString(), FileStorage::READ);
+    }
+    catch (const cv::Exception &e)
+    {
+        return fail(QString("cannot parse %1: %2").arg(yamlPath).arg(QString::fromStdString(e.msg)));
+    }
+    if (!fs.isOpened())
+        return fail(QString("cannot open %1").arg(yamlPath));
+
+    int stages = 0, landmarks = 0;
+    fs["stages_n"] >> stages;
+    fs["landmark_n"] >> landmarks;
+    Mat meanShape;
+    fs["mean_shape"] >> meanShape;
+    if (stages <= 0 || landmarks <= 0 || meanShape.total() != size_t(landmarks) * 2)
+        return fail("not an LBF model (stages_n/landmark_n/mean_shape)");
+
+    // 트리 수/깊이는 모든 단계가 같아야 함(현재 배포 모델이 그러함)
+    int trees = 0, depth = 0;
+    for (int k = 0; k < stages; ++k)
+    {
+        int l = 0, tn = 0, td = 0;
+        fs[format("landmark_n_%d", k)] >> l;
+        fs[format("trees_n_%d", k)] >> tn;
+        fs[format("tree_depth_%d", k)] >> td;
+        if (k == 0)
+        {
+            trees = tn;
+            depth = td;
+        }
+        if (l != landmarks || tn != trees || td != depth || tn <= 0 || td < 2 || td > 16)
+            return fail(QString("stage %1: unsupported forest shape").arg(k));
+    }
+
+    const Layout n(quint32(stages), quint32(landmarks), quint32(trees), quint32(depth));
+    Header h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.byteOrder = kByteOrder;
+    h.stages = quint32(stages);
+    h.landmarks = quint32(landmarks);
+    h.trees = quint32(trees);
+    h.depth = quint32(depth);
+    h.meanShapeOffset = alignUp(sizeof(Header));
+    h.featsOffset = alignUp(h.meanShapeOffset + n.meanShape * sizeof(float));
+    h.thresholdsOffset = alignUp(h.featsOffset + n.feats * sizeof(float));
+    h.weightsOffset = alignUp(h.thresholdsOffset + n.thresholds * sizeof(qint16));
+    h.fileSize = h.weightsOffset + quint64(stages) * n.weightRows * n.weightCols * sizeof(float);
+
+    QSaveFile out(binPath);
+    if (!out.open(QIODevice::WriteOnly))
+        return fail(QString("cannot write %1").arg(binPath));
+    auto pad = [&out]() {
+        static const char zeros[kAlign] = {};
+        const qint64 p = out.pos();
+        out.write(zeros, qint64(alignUp(quint64(p)) - quint64(p)));
+    };
+    auto writeFloats = [&out](const Mat &m) {
+        Mat f;
+        m.convertTo(f, CV_32F);
+        f = f.isContinuous() ? f : f.clone();
+        out.write(reinterpret_cast<const char *>(f.data), qint64(f.total() * f.elemSize()));
+    };
+
+    out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    pad();
+    writeFloats(meanShape.reshape(1, landmarks));
+    pad();
+
+    // 노드 특징과 임계값(단계/랜드마크/트리 순)
+    std::vector<qint16> thresholds;
+    thresholds.reserve(n.thresholds);
+    for (int k = 0; k < stages; ++k)
+        for (int i = 0; i < landmarks; ++i)
+            for (int j = 0; j < trees; ++j)
+            {
+                Mat feats;
+                fs[format("tree_%d_%d_%d", k, i, j)] >> feats;
+                const std::vector<int> th = readInts(fs[format("thresholds_%d_%d_%d", k, i, j)]);
+                if (feats.rows != int(n.nodes) || feats.cols != 4 || th.size() != n.nodes)
+                    return fail(QString("tree %1/%2/%3: unexpected node layout").arg(k).arg(i).arg(j));
+                writeFloats(feats);
+                for (int v : th)
+                    thresholds.push_back(qint16(std::clamp(v, -32768, 32767)));
+            }
+    pad();
+    out.write(reinterpret_cast<const char *>(thresholds.data()), qint64(thresholds.size() * sizeof(qint16)));
+    pad();
+
+    // 회귀 가중치: (L*2) x (L*T*N) → 전치해서 LBF 인덱스별 한 줄
+    for (int k = 0; k < stages; ++k)
+    {
+        Mat w;
+        fs[format("weights_%d", k)] >> w;
+        if (w.rows != int(n.weightCols) || w.cols != int(n.weightRows))
+            return fail(QString("stage %1: unexpected regression weights %2x%3").arg(k).arg(w.rows).arg(w.cols));
+        writeFloats(Mat(w.t()));
+    }
+    if (quint64(out.pos()) != h.fileSize || !out.commit())
+        return fail(QString("write failed: %1").arg(binPath));
+    const double convertMs = t.nsecsElapsed() / 1e6;
+
+    Ptr<LbfModel> model = open(binPath);
+    if (!model)
+        return fail(QString("cannot map %1").arg(binPath));
+    const double err = compareWithReference(yamlPath, *model);
+    if (err < 0 || err > 1.0)
+    {
+        QFile::remove(binPath);
+        return fail(QString("converted model does not match FacemarkLBF (mean error %1 px)").arg(err, 0, 'f', 2));
+    }
+    qInfo("[lbf] %s -> %s: %d stages, %d landmarks, %d trees, depth %d, %.1f MB, %.0f ms, mean error %.3f px", qPrintable(yamlPath), qPrintable(binPath), stages, landmarks, trees, depth, h.fileSize / 1048576.0, convertMs, err);
+    return true;
+}
@@ -0,0 +1,57 @@
+#ifndef LBFMODEL_H
+#define LBFMODEL_H
+
+#include <QFile>
+#include <QString>
+#include <opencv2/face.hpp>
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+/*
+ * 메모리 매핑 LBF 얼굴 랜드마크 모델(OpenCV FacemarkLBF와 같은 추론, 다른 저장 형식)
+ * - convert(): lbfmodel.yaml → 바이너리(.bin) 1회 변환. 변환 직후 FacemarkLBF와 결과를 비교해 다르면 실패
+ * - open()/loadModel(): 파일을 읽기 전용으로 매핑만(파싱/복사 없음). 트리/회귀 가중치는 매핑에서 직접 읽음
+ *   → 여러 프로세스가 같은 페이지를 공유, 실제로 쓰는 페이지만 메모리에 올라감
+ * - fit()은 상태를 바꾸지 않으므로 여러 스레드에서 동시에 호출 가능(FacemarkLBF는 불가)
+ *
+ * 파일 형식(리틀 엔디언, 구역마다 64바이트 정렬)
+ *   헤더 | 평균 형상 float[L][2] | 노드 특징 float[S][L][T][N][4] | 노드 임계값 int16[S][L][T][N]
+ *   | 회귀 가중치 float[S][L*T*N][L*2] (LBF 인덱스별로 연속 → 한 특징의 기여가 한 줄)
+ *   S = 단계, L = 랜드마크, T = 랜드마크당 트리, N = 2^(깊이-1)(노드 0은 사용 안 함)
+ */
+class LbfModel : public cv::face::Facemark
+{
+  public:
+    LbfModel() = default;
+    ~LbfModel() override;
+
+    // yaml을 읽어 bin으로 저장(작업 시간/오차는 로그). 실패 시 error에 이유
+    static bool convert(const QString &yamlPath, const QString &binPath, QString *error = nullptr);
+    // 매핑 열기. 실패 시 nullptr
+    static cv::Ptr<LbfModel> open(const QString &binPath);
+
+    // cv::face::Facemark: 실패 시 cv::Exception(FacemarkLBF와 동일)
+    void loadModel(cv::String model) override;
+    // image: BGR 또는 회색조, faces: std::vector<cv::Rect>, landmarks: std::vector<std::vector<cv::Point2f>>
+    bool fit(cv::InputArray image, cv::InputArray faces, cv::OutputArrayOfArrays landmarks) override;
+
+    bool isOpen() const { return header_ != nullptr; }
+    int landmarkCount() const;
+    // 얼굴 하나(gray: CV_8UC1)
+    bool fitFace(const cv::Mat &gray, const cv::Rect &face, std::vector<cv::Point2f> &landmarks) const;
+
+  private:
+    struct Header;
+
+    bool map(const QString &binPath);
+
+    QFile file_; // 매핑 수명 = 파일 객체 수명
+    const Header *header_ = nullptr;
+    const float *meanShape_ = nullptr;
+    const float *feats_ = nullptr;
+    const qint16 *thresholds_ = nullptr;
+    const float *weights_ = nullptr;
+    cv::Mat meanShapeD_; // 유사 변환 계산용 평균 형상(L x 2 double, 작음)
+};
+
+#endif // LBFMODEL_H
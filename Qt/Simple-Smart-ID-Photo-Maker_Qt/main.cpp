@@ -1,14 +1,64 @@
+#include "lbfmodel.h"
 #include "main_app.h"
+#include "modelregistry.h"
+#include "pipelinebench.h"
+#include "startuptrace.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFileInfo>
 #include <QLocale>
 #include <QTranslator>
 #include <QScreen>
+#include <QTimer>
 
 int main(int argc, char *argv[])
 {
+    StartupTrace::begin();
+
+    // 명령행: --source <스펙> (카메라 대신 파일/이미지/합성 프레임), --bench <프레임 수> (창 없이 측정)
+    QStringList args;
+    for (int i = 0; i < argc; ++i)
+        args << QString::fromLocal8Bit(argv[i]);
+    QCommandLineParser parser;
+    QCommandLineOption sourceOpt("source", "frame source: v4l2[:N] | file:PATH | images:DIR | synthetic[:WxH], optional @fps", "spec");
+    QCommandLineOption benchOpt("bench", "run the headless pipeline benchmark for N frames", "frames");
+    QCommandLineOption budgetOpt("preview-budget", "preview frame cost target in ms (default 30)", "ms");
+    QCommandLineOption liveMatteOpt("live-matte", "replace the real background in the live preview");
+    QCommandLineOption saveCapturesOpt("save-captures", "also save every composed capture as result/suit_<time>.jpg");
+    QCommandLineOption convertLbfOpt("convert-lbf", "convert an LBF facemark YAML model to the memory-mapped .bin format next to it and exit", "yaml");
+    parser.addOption(sourceOpt);
+    parser.addOption(benchOpt);
+    parser.addOption(budgetOpt);
+    parser.addOption(liveMatteOpt);
+    parser.addOption(saveCapturesOpt);
+    parser.addOption(convertLbfOpt);
+    parser.parse(args);
+
+    if (parser.isSet(convertLbfOpt))
+    {
+        QCoreApplication app(argc, argv);
+        const QFileInfo yaml(parser.value(convertLbfOpt));
+        QString error;
+        if (LbfModel::convert(yaml.filePath(), yaml.dir().filePath(yaml.completeBaseName() + ".bin"), &error))
+            return 0;
+        qCritical("[lbf] %s", qPrintable(error));
+        return 1;
+    }
+
+    if (parser.isSet(benchOpt))
+    {
+        QCoreApplication app(argc, argv);
+        ModelRegistry::instance().preload();
+        return runPipelineBench(parser.value(sourceOpt), parser.value(benchOpt).toInt());
+    }
+
     QApplication a(argc, argv);
 
+    // 검출 모델(캐스케이드/랜드마크)은 창/장치 준비와 병렬로 백그라운드 로드(앱 객체 생성 후: 경로/설정이 앱 기준)
+    ModelRegistry::instance().preload();
+
     QTranslator translator;
     const QStringList uiLanguages = QLocale::system().uiLanguages();
     for (const QString &locale : uiLanguages)
@@ -20,7 +70,11 @@ int main(int argc, char *argv[])
             break;
         }
     }
-    main_app w;
+    main_app w(nullptr, parser.value(sourceOpt));
+    if (parser.isSet(budgetOpt))
+        w.setPreviewBudgetMs(parser.value(budgetOpt).toDouble());
+    w.setLiveMatte(parser.isSet(liveMatteOpt));
+    w.setSaveCaptures(parser.isSet(saveCapturesOpt));
     w.show();
 
     // Center the window
@@ -30,5 +84,8 @@ int main(int argc, char *argv[])
     int y = (screenGeometry.height() - w.height()) / 2;
     w.move(x, y);
 
+    // 첫 이벤트 루프 진입 = 창 표시 완료(장치/리소스 로드는 백그라운드에서 계속)
+    QTimer::singleShot(0, [] { StartupTrace::mark("window shown"); });
+
     return a.exec();
 }
@@ -1,20 +1,28 @@
 #include "main_app.h"
+#include "backgroundcolor.h"
+#include "startuptrace.h"
 #include "ui_main_app.h"
 #include <QDateTime>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QImage>
 #include <QPixmap>
-#include <QTimer>
+#include <QShortcut>
+#include <QtConcurrent>
 
-main_app::main_app(QWidget *parent) : QWidget(parent), editPage(nullptr), exportPage(nullptr), ui(new Ui::main_app), timer(new QTimer(this))
+// 클린 플레이트 저장 위치(촬영 결과와 같은 작업 디렉터리 기준)
+static const char *const kCleanPlatePath = "clean_plate.png";
+static constexpr int kStillTimeoutMs = 3000; // 고해상도 스틸 대기 한도(넘으면 프리뷰 프레임으로 합성)
+static const cv::Size kStillSize(1920, 1080);
+
+main_app::main_app(QWidget *parent, const QString &sourceSpec) : QWidget(parent), editPage(nullptr), exportPage(nullptr), ui(new Ui::main_app), grabber_(new FrameGrabber(this)), composeTask_(new ComposeTask(comp_, this)), scheduler_(new PreviewScheduler(this))
 {
     ui->setupUi(this);
 
-    // 합성 엔진 초기화
+    // 합성 엔진 초기화(리소스는 창을 띄운 뒤 백그라운드에서 로드)
     comp_.setCanvas(300, 400, 290);
-    comp_.loadSuit("../../image/man_suit_bg_remove.png");
-    comp_.loadGuide("../../image/man_suit_bg_remove.png");
     comp_.setMirror(true);
     comp_.setGuideVisible(true);
     comp_.setGuideOpacity(0.7);
@@ -23,25 +31,73 @@ main_app::main_app(QWidget *parent) : QWidget(parent), editPage(nullptr), export
     selectedBackgroundColor = cv::Scalar(255, 255, 255);
     comp_.setBackgroundColor(selectedBackgroundColor);
 
-    // 카메라
-    camera.open(0, cv::CAP_V4L2);
-    if (!camera.isOpened())
-        camera.open(0, cv::CAP_ANY);
-    if (camera.isOpened())
+    // 카메라(캡처 스레드): 새 프레임 공개 시 GUI 스레드에서 프리뷰 갱신
+    connect(grabber_, &FrameGrabber::frameReady, this, &main_app::updateFrame);
+
+    // 프리뷰 비용 측정 → 예산을 넘으면 가이드 품질/해상도/속도를 단계적으로 낮춤
+    connect(ui->camScreen, &AspectRatioLabel::painted, this, [this](double ms) { scheduler_->record(PreviewScheduler::Stage::Paint, ms); });
+    connect(scheduler_, &PreviewScheduler::modeChanged, this, &main_app::onPreviewModeChanged);
+    ui->camScreen->setScaledContents(true);
+
+    // 촬영 버튼(리소스 로드 전에는 비활성)
+    connect(ui->takePhotoButton, &QPushButton::clicked, this, &main_app::capturePhoto);
+    ui->takePhotoButton->setEnabled(false);
+
+    // 백그라운드 합성: 진행률 표시 + 완료 시 편집 페이지로 이동
+    ui->composeProgress->hide();
+    connect(composeTask_, &ComposeTask::progress, this, &main_app::onComposeProgress);
+    connect(composeTask_, &ComposeTask::composed, this, &main_app::onComposed);
+    connect(composeTask_, &ComposeTask::failed, this, &main_app::onComposeFailed);
+
+    // 프레임 공급원: 기본은 카메라 0, 스펙으로 파일/이미지/합성 프레임 대체 가능
+    std::unique_ptr<FrameSource> source = FrameSource::create(sourceSpec);
+    if (!source)
     {
-        camera.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'));
-        camera.set(cv::CAP_PROP_FRAME_WIDTH, 640);
-        camera.set(cv::CAP_PROP_FRAME_HEIGHT, 480);
+        qWarning() << "unknown frame source:" << sourceSpec << "- using camera 0";
+        source = std::make_unique<V4l2FrameSource>(0);
     }
+    if (auto *cam = dynamic_cast<V4l2FrameSource *>(source.get()))
+    {
+        // 프리뷰는 MJPEG 1/2 축소 디코드, 전체 디코드는 촬영 프레임에서만
+        cam->setDecodeMode(V4l2FrameSource::DecodeMode::ReducedMjpeg);
+        // 셔터 시에만 고해상도 스틸(해상도 전환 방식)
+        stillSize_ = kStillSize;
+        cam->setStillResolution(stillSize_);
+    }
+    // 장치 열기/포맷 협상은 캡처 스레드에서, 리소스 로드는 스레드 풀에서 동시에 진행
+    connect(grabber_, &FrameGrabber::opened, this, &main_app::onSourceOpened);
+    grabber_->openAsync(std::move(source));
 
-    // 타이머
-    connect(timer, &QTimer::timeout, this, &main_app::updateFrame);
+    connect(&assetWatcher_, &QFutureWatcher<SuitAssets>::finished, this, &main_app::onAssetsLoaded);
+    assetWatcher_.setFuture(QtConcurrent::run([] {
+        SuitAssets assets = SuitComposer::loadAssets("../../image/man_suit_bg_remove.png", "../../image/man_suit_bg_remove.png", cv::Size(300, 400));
+        assets.cleanPlate = cv::imread(kCleanPlatePath, cv::IMREAD_COLOR); // 없으면 빈 Mat
+        return assets;
+    }));
 
-    // 촬영 버튼
-    connect(ui->takePhotoButton, &QPushButton::clicked, this, &main_app::capturePhoto);
+    // 운영자용: 빈 배경(클린 플레이트) 촬영/삭제
+    connect(new QShortcut(QKeySequence("Ctrl+P"), this), &QShortcut::activated, this, &main_app::captureCleanPlate);
+    connect(new QShortcut(QKeySequence("Ctrl+Shift+P"), this), &QShortcut::activated, this, &main_app::clearCleanPlate);
+}
 
-    if (camera.isOpened())
-        timer->start(30);
+void main_app::onAssetsLoaded()
+{
+    StartupTrace::mark("assets loaded");
+    SuitAssets assets = assetWatcher_.result();
+    if (!assets.trackerDet.empty())
+        faceTracker_.setDetector(assets.trackerDet);
+    if (comp_.setAssets(std::move(assets)))
+        ui->takePhotoButton->setEnabled(true);
+    else
+        qWarning() << "suit asset missing - capture disabled";
+}
+
+void main_app::onSourceOpened(bool ok)
+{
+    if (ok)
+        StartupTrace::mark("camera opened");
+    else
+        qWarning() << "frame source open fail:" << (grabber_->source() ? grabber_->source()->describe() : QString());
 }
 
 void main_app::resizeEvent(QResizeEvent *event)
@@ -54,58 +110,212 @@ void main_app::resizeEvent(QResizeEvent *event)
     }
 }
 
+void main_app::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    updatePreviewActivity();
+}
+
+void main_app::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    updatePreviewActivity();
+}
+
+void main_app::changeEvent(QEvent *event)
+{
+    QWidget::changeEvent(event);
+    if (event->type() == QEvent::WindowStateChange)
+        updatePreviewActivity();
+}
+
+/* 보이는 동안만 캡처/디코드/프리뷰 수행(장치는 열린 상태 유지) */
+void main_app::updatePreviewActivity()
+{
+    const bool visible = isVisible() && !isMinimized();
+    grabber_->setStandby(!visible);
+}
+
 void main_app::updateFrame()
 {
-    if (!camera.isOpened())
+    // 밀린 프레임은 건너뛰고 가장 최신 프레임만 사용
+    if (!grabber_->acquireLatest())
         return;
+    const CapturedFrame &frame = grabber_->latest();
+    if (frame.bgr.empty() || !scheduler_->admit(std::chrono::steady_clock::now()))
+        return;
+    const PreviewScheduler::Mode &mode = scheduler_->mode();
+    scheduler_->record(PreviewScheduler::Stage::Decode, frame.decodeMs);
+
+    // 실시간 매트: 색 모델이 없으면(세션 시작/초기화 후) 이 프레임으로 준비
+    // 클린 플레이트 분할이면 프리뷰가 플레이트 색 차를 바로 쓰므로 색 모델이 필요 없음
+    const bool plateMatte = comp_.segmentMode() == SuitComposer::SegmentMode::CleanPlate && comp_.hasCleanPlate();
+    if (comp_.liveMatte() && comp_.isReady() && !plateMatte && !comp_.hasLiveMatteModel())
+        startLiveWarmUp(frame.bgr);
 
-    camera >> lastFrameBGR_;
-    if (lastFrameBGR_.empty())
+    // 얼굴 위치 추적(대부분 ROI 검출) → 촬영 시 합성의 얼굴 검출 범위로 전달. 비용은 프리뷰와 따로 기록
+    if (faceTracker_.hasDetector())
+    {
+        const FaceTracker::Result &face = faceTracker_.update(frame.bgr);
+        scheduler_->record(PreviewScheduler::Stage::Track, face.ms);
+        const cv::Rect2f &r = face.rect;
+        const float w = float(frame.bgr.cols), h = float(frame.bgr.rows);
+        comp_.setFaceHint(cv::Rect2f(r.x / w, r.y / h, r.width / w, r.height / h), face.confidence);
+    }
+
+    // 수트 가이드(또는 실시간 매트)를 포함한 프리뷰(BGR)
+    QElapsedTimer t;
+    t.start();
+    comp_.makePreview(frame.bgr, previewBGR_, mode.scale, mode.guide);
+    scheduler_->record(PreviewScheduler::Stage::Preview, t.nsecsElapsed() / 1e6);
+
+    // Mat(BGR) -> QPixmap: 버퍼를 감싼 QImage에서 바로 복사(그리기 비용은 painted()로 따로 측정)
+    t.start();
+    const QImage view(previewBGR_.data, previewBGR_.cols, previewBGR_.rows, int(previewBGR_.step), QImage::Format_BGR888);
+    QPixmap pixmap = QPixmap::fromImage(view);
+    scheduler_->record(PreviewScheduler::Stage::Convert, t.nsecsElapsed() / 1e6);
+
+    ui->camScreen->setPixmap(pixmap);
+    scheduler_->endFrame();
+    StartupTrace::mark("first preview frame");
+}
+
+/* 실시간 매트 색 모델 준비(한 번에 하나). 실패하면 1초부터 두 배씩, 최대 30초 뒤에 다시 시도 */
+void main_app::startLiveWarmUp(const cv::Mat &frameBGR)
+{
+    if (!liveWarmUp_.isFinished())
         return;
+    const auto now = std::chrono::steady_clock::now();
+    if (liveWarmUpPending_)
+    {
+        liveWarmUpPending_ = false;
+        if (liveWarmUp_.result())
+            liveWarmUpFailures_ = 0;
+        else
+        {
+            const auto backoff = std::chrono::seconds(std::min(30, 1 << std::min(liveWarmUpFailures_, 5)));
+            ++liveWarmUpFailures_;
+            liveWarmUpRetryAt_ = now + backoff;
+        }
+    }
+    if (now < liveWarmUpRetryAt_)
+        return;
+    liveWarmUp_ = composeTask_->warmUp(frameBGR);
+    liveWarmUpPending_ = true;
+}
 
-    // 수트 가이드를 포함한 프리뷰(BGR)
-    cv::Mat prevBGR = comp_.makePreviewBGR(lastFrameBGR_);
+void main_app::setPreviewBudgetMs(double ms) { scheduler_->setBudgetMs(ms); }
 
-    // Mat(BGR) -> QImage
-    QImage qimg = SuitComposer::matBGR2QImage(prevBGR);
+void main_app::setLiveMatte(bool on) { comp_.setLiveMatte(on); }
 
-    ui->camScreen->setPixmap(QPixmap::fromImage(qimg));
-    ui->camScreen->setScaledContents(true);
+void main_app::setSaveCaptures(bool on) { saveCaptures_ = on; }
+
+void main_app::captureCleanPlate()
+{
+    grabber_->acquireLatest();
+    const cv::Mat plate = grabber_->latest().fullResBGR();
+    if (plate.empty())
+        return;
+    comp_.setCleanPlate(plate);
+    comp_.setSegmentMode(SuitComposer::SegmentMode::CleanPlate);
+    (void)QtConcurrent::run([plate]() { cv::imwrite(kCleanPlatePath, plate); });
+    qInfo() << "clean plate captured:" << plate.cols << "x" << plate.rows;
+}
+
+void main_app::clearCleanPlate()
+{
+    comp_.setCleanPlate(cv::Mat());
+    comp_.setSegmentMode(SuitComposer::SegmentMode::RoiMultiRes);
+    QFile::remove(kCleanPlatePath);
+}
+
+void main_app::onPreviewModeChanged(const PreviewScheduler::Mode &mode, double costMs)
+{
+    qInfo().noquote() << "[preview]" << mode.describe() << QString("(cost %1 ms, budget %2 ms)").arg(costMs, 0, 'f', 1).arg(scheduler_->budgetMs(), 0, 'f', 1);
+    ui->camScreen->setToolTip(mode.describe());
 }
 
 void main_app::capturePhoto()
 {
-    if (lastFrameBGR_.empty())
+    // 프리뷰와 같은 트리플 버퍼의 최신 프레임(비트스트림 포함 얕은 복사)을 예비로 확보
+    grabber_->acquireLatest();
+    const CapturedFrame &previewFrame = grabber_->latest();
+    if (previewFrame.bgr.empty())
+        return;
+    CapturedFrame fallback;
+    fallback.bgr = previewFrame.bgr.clone();
+    fallback.jpeg = previewFrame.jpeg.clone();
+
+    // 스틸로 출력 해상도가 올라가지 않으면(수트 원본이 캔버스 크기 등) 요청하지 않고 프리뷰 프레임으로 합성
+    // (프리뷰가 축소 디코드면 전체 디코드 크기는 2배)
+    const cv::Size previewFullSize = fallback.jpeg.empty() ? fallback.bgr.size() : fallback.bgr.size() * 2;
+    FrameProvider frameProvider = [fallback](const std::function<bool()> &) { return fallback.fullResBGR(); };
+    if (stillSize_.area() > 0 && comp_.outputSizeFor(stillSize_) != comp_.outputSizeFor(previewFullSize))
     {
-        if (!camera.isOpened())
-            return;
-        camera >> lastFrameBGR_;
-        if (lastFrameBGR_.empty())
-            return;
+        // 고해상도 스틸 요청. 대기와 전체 디코드는 작업 스레드에서, 실패/시간 초과 시 프리뷰 프레임 사용
+        // 대기는 짧게 끊어서: 취소(재촬영/새 셔터)되면 바로 빠짐
+        std::shared_future<cv::Mat> still = grabber_->requestStill();
+        frameProvider = [still, fallback](const std::function<bool()> &cancelled) {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kStillTimeoutMs);
+            while (still.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready)
+            {
+                if (cancelled())
+                    return cv::Mat();
+                if (std::chrono::steady_clock::now() >= deadline)
+                    return fallback.fullResBGR();
+            }
+            cv::Mat frame = still.get();
+            return frame.empty() ? fallback.fullResBGR() : frame;
+        };
     }
 
-    // 수트 ⊕ 얼굴 합성 + 배경색 적용된 BGR 이미지
-    cv::Mat outBGR = comp_.composeBGR(lastFrameBGR_);
+    // 저장 경로(선택): 저장은 편집 페이지 전달과 별개로 백그라운드에서 수행
+    QString savePath;
+    if (saveCaptures_)
+    {
+        QDir().mkpath("result");
+        const QString ts = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+        savePath = QString("result/suit_%1.jpg").arg(ts); // JPG로 변경
+    }
 
-    // 저장 경로
-    QDir().mkpath("result");
-    const QString ts = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
-    currentImagePath = QString("result/suit_%1.jpg").arg(ts); // JPG로 변경
+    // 수트 ⊕ 얼굴 합성 + 배경색 적용은 작업 스레드에서(프리뷰는 계속 갱신)
+    // 진행 중인 합성이 있으면 취소되고 이 프레임으로 다시 시작
+    ui->composeProgress->setValue(0);
+    ui->composeProgress->show();
+    composeTask_->start(frameProvider, selectedBackgroundColor, savePath);
+}
 
-    // JPG BGR 저장
-    cv::imwrite(currentImagePath.toStdString(), outBGR, {cv::IMWRITE_JPEG_QUALITY, 95});
+void main_app::onComposeProgress(int percent) { ui->composeProgress->setValue(percent); }
 
-    // 편집 페이지로 이동
+void main_app::onComposed(const ComposeResult &result)
+{
+    ui->composeProgress->hide();
+    currentImagePath = result.savePath;
+
+    // 편집 페이지로 이동: 합성 결과를 메모리로 바로 전달(JPG 재디코드 없음)
     if (!editPage)
     {
         editPage = new PhotoEditPage();
         editPage->setMainApp(this);
     }
-    editPage->loadImage(currentImagePath);
+    cv::Mat alpha;
+    cv::extractChannel(result.rgba, alpha, 3);
+    editPage->loadImage(result.bgr, alpha, result.bgColor);
     editPage->show();
     this->hide();
 }
 
+void main_app::onComposeFailed() { ui->composeProgress->hide(); }
+
+void main_app::retake()
+{
+    composeTask_->cancel();
+    ui->composeProgress->hide();
+    if (editPage)
+        editPage->hide();
+    this->show();
+}
+
 void main_app::goToExportPage()
 {
     if (!exportPage)
@@ -128,13 +338,18 @@ void main_app::goToExportPageWithImage()
         cv::Mat editedImage = editPage->getCurrentImage();
         if (!editedImage.empty())
         {
-            exportPage->setResultImage(editedImage);
+            exportPage->setResultImage(editedImage, editPage->getCurrentAlpha(), editPage->getBackgroundColor(), editPage->isGrayscale());
         }
         else
         {
         }
     }
 
+    // 촬영 세션 종료: 재촬영용 색 모델은 다음 손님에게 쓰지 않음(실시간 매트 재시도 간격도 처음부터)
+    comp_.resetWarmStart();
+    liveWarmUpFailures_ = 0;
+    liveWarmUpRetryAt_ = std::chrono::steady_clock::time_point();
+
     exportPage->show();
     editPage->hide();
     this->hide();
@@ -143,22 +358,7 @@ void main_app::goToExportPageWithImage()
 void main_app::on_colorSelect_currentTextChanged(const QString &text)
 {
     // 선택된 색상에 따라 배경색 설정 (BGR 순서)
-    if (text == "흰색")
-    {
-        selectedBackgroundColor = cv::Scalar(255, 255, 255);
-    }
-    else if (text == "파란색")
-    {
-        selectedBackgroundColor = cv::Scalar(255, 0, 0);
-    }
-    else if (text == "빨간색")
-    {
-        selectedBackgroundColor = cv::Scalar(0, 0, 255);
-    }
-    else if (text == "회색")
-    {
-        selectedBackgroundColor = cv::Scalar(128, 128, 128);
-    }
+    selectedBackgroundColor = BackgroundColor::fromName(text, selectedBackgroundColor);
 
     // SuitComposer에 배경색 적용
     comp_.setBackgroundColor(selectedBackgroundColor);
@@ -166,7 +366,8 @@ void main_app::on_colorSelect_currentTextChanged(const QString &text)
 
 main_app::~main_app()
 {
-    camera.release();
+    grabber_->stop();
+    delete composeTask_; // comp_보다 먼저: 진행 중 작업 취소 후 종료 대기
     delete editPage;
     delete exportPage;
     delete ui;
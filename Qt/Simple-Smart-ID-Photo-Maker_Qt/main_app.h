@@ -1,12 +1,17 @@
 #ifndef MAIN_APP_H
 #define MAIN_APP_H
 
+#include "composetask.h"
 #include "export_page.h"
+#include "facetracker.h"
+#include "framegrabber.h"
 #include "photoeditpage.h"
+#include "previewscheduler.h"
 #include "suitcomposer.h"
+#include <QFutureWatcher>
 #include <QResizeEvent>
-#include <QTimer>
 #include <QWidget>
+#include <chrono>
 #include <opencv2/opencv.hpp>
 
 QT_BEGIN_NAMESPACE
@@ -20,7 +25,8 @@ class main_app : public QWidget
 {
     Q_OBJECT
   public:
-    explicit main_app(QWidget *parent = nullptr);
+    // sourceSpec: FrameSource 스펙(비어 있으면 카메라 0)
+    explicit main_app(QWidget *parent = nullptr, const QString &sourceSpec = QString());
     ~main_app();
 
     PhotoEditPage *editPage;
@@ -30,22 +36,49 @@ class main_app : public QWidget
   public slots:
     void goToExportPage();
     void goToExportPageWithImage();
+    void retake(); // 진행 중 합성 취소 후 촬영 화면으로 복귀
+    void setPreviewBudgetMs(double ms); // 프리뷰 프레임 비용 목표(기본 30ms)
+    void setLiveMatte(bool on);         // 프리뷰에서 실제 배경을 선택 배경색으로 대체(색 모델은 첫 프레임으로 준비)
+    void setSaveCaptures(bool on);      // 촬영 합성 결과를 result/에도 저장(기본 꺼짐)
+    void captureCleanPlate();           // 현재 프레임을 빈 배경으로 저장 → 플레이트 색 차 분할(Ctrl+P)
+    void clearCleanPlate();             // 플레이트 삭제 → GrabCut 분할(Ctrl+Shift+P)
 
   protected:
     void resizeEvent(QResizeEvent *event) override;
+    // 화면이 가려지거나 최소화되면 프리뷰 파이프라인 대기, 다시 보이면 재개
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    void changeEvent(QEvent *event) override;
 
   private slots:
-    void updateFrame();  // 프리뷰만 갱신
-    void capturePhoto(); // 수트 합성 후 저장
+    void updateFrame();  // 최신 프레임으로 프리뷰만 갱신
+    void capturePhoto(); // 백그라운드 수트 합성 시작(진행 중이면 취소 후 재시작)
+    void onComposeProgress(int percent);
+    void onComposed(const ComposeResult &result);
+    void onComposeFailed();
+    void onAssetsLoaded();           // 수트/가이드/검출기 로드 완료 → 촬영 가능
+    void onSourceOpened(bool ok);    // 캡처 스레드의 장치 열기 결과
+    void updatePreviewActivity();
+    void onPreviewModeChanged(const PreviewScheduler::Mode &mode, double costMs);
     void on_colorSelect_currentTextChanged(const QString &text);
 
   private:
-    Ui::main_app *ui;
-    cv::VideoCapture camera;
-    QTimer *timer;
+    void startLiveWarmUp(const cv::Mat &frameBGR); // 실시간 매트 색 모델 준비(실패 후에는 간격을 늘려 재시도)
 
-    cv::Mat lastFrameBGR_;              // 최신 원본 프레임
+    Ui::main_app *ui;
+    FrameGrabber *grabber_;             // 캡처/디코드 스레드(최신 프레임 공개)
     SuitComposer comp_;                 // 합성 엔진
+    ComposeTask *composeTask_;          // 백그라운드 합성 작업
+    PreviewScheduler *scheduler_;       // 프리뷰 속도/해상도/가이드 품질 조정
+    cv::Mat previewBGR_;                // 프리뷰 출력 버퍼(프레임마다 재사용)
+    FaceTracker faceTracker_;           // 프리뷰 프레임 얼굴 위치(전체 검출은 주기/분실 시만)
+    QFutureWatcher<SuitAssets> assetWatcher_; // 시작 시 백그라운드 리소스 로드
+    QFuture<bool> liveWarmUp_;          // 실시간 매트 색 모델 준비 작업
+    bool liveWarmUpPending_ = false;    // liveWarmUp_ 결과를 아직 확인하지 않음
+    int liveWarmUpFailures_ = 0;        // 연속 실패 횟수(재시도 간격)
+    std::chrono::steady_clock::time_point liveWarmUpRetryAt_;
     cv::Scalar selectedBackgroundColor; // 선택된 배경색 (BGR)
+    cv::Size stillSize_;                // 셔터 시 요청하는 고해상도 스틸(카메라가 아니면 빈 Size)
+    bool saveCaptures_ = false;         // 촬영 결과를 result/에 백그라운드 저장할지
 };
 #endif // MAIN_APP_H
@@ -0,0 +1,240 @@
+#include "modelregistry.h"
+#include "lbfmodel.h"
+#include "startuptrace.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutexLocker>
+#include <QSettings>
+#include <QtConcurrent>
+using namespace cv;
+
+namespace
+{
+// 설정이 없을 때의 기존 위치(시스템 OpenCV 설치, 작업 디렉터리)
+const QStringList kSystemCascadeDirs = {"/usr/share/opencv4/haarcascades/", "/usr/local/share/opencv4/haarcascades/", "/usr/share/opencv/haarcascades/", ""};
+} // namespace
+
+/* 메모리의 XML 원문에서 캐스케이드 구성(디스크/경로 탐색 없음). 구형 형식이면 false */
+static bool readCascade(CascadeClassifier &det, const std::string &xml)
+{
+    try
+    {
+        FileStorage fs(xml, FileStorage::READ | FileStorage::MEMORY);
+        return fs.isOpened() && det.read(fs.getFirstTopLevelNode()) && !det.empty();
+    }
+    catch (const cv::Exception &)
+    {
+        return false;
+    }
+}
+
+ModelRegistry &ModelRegistry::instance()
+{
+    static ModelRegistry registry;
+    return registry;
+}
+
+const char *ModelRegistry::name(Kind kind)
+{
+    switch (kind)
+    {
+    case Kind::FaceCascade:
+        return "face cascade";
+    case Kind::EyeCascade:
+        return "eye cascade";
+    case Kind::Facemark:
+        return "facemark";
+    default:
+        return "?";
+    }
+}
+
+/* 설정 읽기(로드는 preload()에서) */
+ModelRegistry::ModelRegistry()
+{
+    pool_.setMaxThreadCount(int(Kind::Count));
+    const QString ini = qEnvironmentVariable("IDPHOTO_MODELS", "models.ini");
+    QSettings settings(ini, QSettings::IniFormat);
+    settings.beginGroup("models");
+    modelDir_ = settings.value("dir", qEnvironmentVariable("IDPHOTO_MODEL_DIR")).toString();
+    configured_[int(Kind::FaceCascade)] = settings.value("face_cascade").toString();
+    configured_[int(Kind::EyeCascade)] = settings.value("eye_cascade").toString();
+    configured_[int(Kind::Facemark)] = settings.value("facemark").toString();
+    settings.endGroup();
+}
+
+/* 시도할 경로: 설정의 개별 파일 → 설정 디렉터리 → 기존 후보 */
+QStringList ModelRegistry::candidates(Kind kind) const
+{
+    QStringList files;
+    switch (kind)
+    {
+    case Kind::FaceCascade:
+        files = {"haarcascade_frontalface_default.xml"};
+        break;
+    case Kind::EyeCascade:
+        files = {"haarcascade_eye.xml", "haarcascade_eye_tree_eyeglasses.xml", "haarcascade_lefteye_2splits.xml", "haarcascade_righteye_2splits.xml"};
+        break;
+    default:
+        files = {"lbfmodel.bin", "lbfmodel.yaml"}; // 변환한 매핑 형식 우선
+        break;
+    }
+
+    QStringList paths;
+    if (!configured_[int(kind)].isEmpty())
+        paths << configured_[int(kind)];
+    if (!modelDir_.isEmpty())
+        for (const QString &f : files)
+            paths << QDir(modelDir_).filePath(f);
+    if (kind == Kind::Facemark)
+        paths << files; // 작업 디렉터리
+    else
+        for (const QString &dir : kSystemCascadeDirs)
+            for (const QString &f : files)
+                paths << dir + f;
+    paths.removeDuplicates();
+    return paths;
+}
+
+void ModelRegistry::record(Kind kind, const QString &path, double ms)
+{
+    {
+        QMutexLocker lock(&mutex_);
+        Info &i = info_[int(kind)];
+        i.path = path;
+        i.loadMs = ms;
+        i.ok = !path.isEmpty();
+    }
+    if (path.isEmpty())
+        qWarning("[models] %s: not found", name(kind));
+    else
+        qInfo("[models] %s: %s (%.1f ms)", name(kind), qPrintable(path), ms);
+    StartupTrace::mark(name(kind));
+}
+
+/* 캐스케이드 로드(작업 스레드): 파일을 한 번 읽어 원문을 보관하고 그 원문에서 공유 인스턴스 구성 */
+Ptr<CascadeClassifier> ModelRegistry::loadCascade(Kind kind)
+{
+    QElapsedTimer t;
+    t.start();
+    for (const QString &path : candidates(kind))
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            continue;
+        auto xml = std::make_shared<const std::string>(file.readAll().toStdString());
+        Ptr<CascadeClassifier> det = makePtr<CascadeClassifier>();
+        if (!readCascade(*det, *xml))
+        {
+            // 구형 형식: 경로에서 직접(독립 인스턴스도 경로에서)
+            xml.reset();
+            if (!det->load(path.toStdString()))
+                continue;
+        }
+        {
+            QMutexLocker lock(&mutex_);
+            xml_[int(kind)] = std::move(xml);
+        }
+        record(kind, path, t.nsecsElapsed() / 1e6);
+        return det;
+    }
+    record(kind, QString(), t.nsecsElapsed() / 1e6);
+    return nullptr;
+}
+
+/* 랜드마크 모델 로드(작업 스레드): .bin은 매핑만, .yaml은 FacemarkLBF로 파싱 */
+Ptr<face::Facemark> ModelRegistry::loadFacemark()
+{
+    QElapsedTimer t;
+    t.start();
+    for (const QString &path : candidates(Kind::Facemark))
+    {
+        if (!QFile::exists(path))
+            continue;
+        if (path.endsWith(".bin"))
+        {
+            if (Ptr<LbfModel> fm = LbfModel::open(path))
+            {
+                record(Kind::Facemark, path, t.nsecsElapsed() / 1e6);
+                return fm;
+            }
+            qWarning("[models] %s: %s is not a valid mapped model", name(Kind::Facemark), qPrintable(path));
+            continue;
+        }
+        try
+        {
+            Ptr<face::FacemarkLBF> fm = face::FacemarkLBF::create();
+            fm->loadModel(path.toStdString());
+            record(Kind::Facemark, path, t.nsecsElapsed() / 1e6);
+            qInfo("[models] convert once with --convert-lbf %s for a mapped model", qPrintable(path));
+            return fm;
+        }
+        catch (const cv::Exception &)
+        {
+        }
+    }
+    record(Kind::Facemark, QString(), t.nsecsElapsed() / 1e6);
+    return nullptr;
+}
+
+/* 모델마다 작업 하나씩(이미 시작했으면 무시) */
+void ModelRegistry::preload()
+{
+    QMutexLocker lock(&mutex_);
+    if (started_)
+        return;
+    started_ = true;
+    face_ = QtConcurrent::run(&pool_, [this] { return loadCascade(Kind::FaceCascade); });
+    eye_ = QtConcurrent::run(&pool_, [this] { return loadCascade(Kind::EyeCascade); });
+    facemark_ = QtConcurrent::run(&pool_, [this] { return loadFacemark(); });
+}
+
+QFuture<Ptr<CascadeClassifier>> ModelRegistry::faceCascade()
+{
+    preload();
+    QMutexLocker lock(&mutex_);
+    return face_;
+}
+
+QFuture<Ptr<CascadeClassifier>> ModelRegistry::eyeCascade()
+{
+    preload();
+    QMutexLocker lock(&mutex_);
+    return eye_;
+}
+
+QFuture<Ptr<face::Facemark>> ModelRegistry::facemark()
+{
+    preload();
+    QMutexLocker lock(&mutex_);
+    return facemark_;
+}
+
+/* 공유 인스턴스와 같은 원문에서 새 인스턴스(로드 완료 대기) */
+Ptr<CascadeClassifier> ModelRegistry::createCascade(Kind kind)
+{
+    if (!(kind == Kind::FaceCascade ? faceCascade() : eyeCascade()).result())
+        return nullptr;
+    std::shared_ptr<const std::string> xml;
+    QString path;
+    {
+        QMutexLocker lock(&mutex_);
+        xml = xml_[int(kind)];
+        path = info_[int(kind)].path;
+    }
+    Ptr<CascadeClassifier> det = makePtr<CascadeClassifier>();
+    if ((xml && readCascade(*det, *xml)) || det->load(path.toStdString()))
+        return det;
+    return nullptr;
+}
+
+Ptr<CascadeClassifier> ModelRegistry::createFaceCascade() { return createCascade(Kind::FaceCascade); }
+
+Ptr<CascadeClassifier> ModelRegistry::createEyeCascade() { return createCascade(Kind::EyeCascade); }
+
+ModelRegistry::Info ModelRegistry::info(Kind kind) const
+{
+    QMutexLocker lock(&mutex_);
+    return info_[int(kind)];
+}
@@ -0,0 +1,100 @@
+#ifndef MODELREGISTRY_H
+#define MODELREGISTRY_H
+
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <memory>
+#include <opencv2/face.hpp>
+#include <opencv2/opencv.hpp>
+#include <string>
+
+/*
+ * 프로세스 전체 검출 모델 저장소(얼굴/눈 캐스케이드, 얼굴 랜드마크)
+ * - 경로는 설정에서: ini 파일(환경 변수 IDPHOTO_MODELS, 기본 ./models.ini)의 [models] 그룹
+ *     dir = 모델 디렉터리(기본 파일명으로 찾음), face_cascade / eye_cascade / facemark = 개별 파일
+ *   환경 변수 IDPHOTO_MODEL_DIR도 dir로 사용. 설정에 없으면 기존 후보 경로를 차례로 시도
+ *   랜드마크는 변환한 lbfmodel.bin(LbfModel, 매핑만)을 lbfmodel.yaml보다 먼저 찾음
+ * - preload()는 모델마다 한 번씩 전용 스레드 풀에서 병렬 로드(여러 번 호출해도 한 번)
+ * - 공유 인스턴스는 준비 future로 전달. 검출 호출은 분류기 내부 버퍼를 바꾸므로 공유 캐스케이드는 GUI 스레드 전용
+ *   다른 스레드는 createFaceCascade()/createEyeCascade()로 독립 인스턴스(메모리에 둔 XML에서 구성, 경로 탐색 없음)
+ *   랜드마크는 편집 페이지 분석 작업만 사용(FacemarkLBF의 fit은 동시 호출 불가, LbfModel은 가능)
+ * - 모델별 경로/로드 시간은 info()와 "[models]" 로그로 보고
+ */
+class ModelRegistry
+{
+  public:
+    enum class Kind
+    {
+        FaceCascade,
+        EyeCascade,
+        Facemark,
+        Count
+    };
+
+    struct Info
+    {
+        QString path;        // 로드한 파일(실패 시 빈 문자열)
+        double loadMs = -1.; // 읽기 + 파싱 시간(< 0: 아직 로드 전)
+        bool ok = false;
+    };
+
+    static ModelRegistry &instance();
+    static const char *name(Kind kind);
+
+    // 전체 모델 백그라운드 로드 시작(어느 스레드에서나, 즉시 반환)
+    void preload();
+
+    // 공유 인스턴스 준비 future(실패 시 결과가 nullptr). 필요하면 로드 시작
+    QFuture<cv::Ptr<cv::CascadeClassifier>> faceCascade();
+    QFuture<cv::Ptr<cv::CascadeClassifier>> eyeCascade();
+    QFuture<cv::Ptr<cv::face::Facemark>> facemark();
+
+    // 작업 스레드 전용 독립 인스턴스(로드 완료까지 대기 → GUI 스레드에서 호출 금지). 실패 시 nullptr
+    cv::Ptr<cv::CascadeClassifier> createFaceCascade();
+    cv::Ptr<cv::CascadeClassifier> createEyeCascade();
+
+    Info info(Kind kind) const;
+
+    // future가 끝나면 ctx 스레드에서 fn(결과) 호출(이미 끝났으면 다음 이벤트 루프에서). ctx가 사라지면 취소
+    template <typename T, typename F> static void onReady(QObject *ctx, const QFuture<T> &future, F fn);
+
+  private:
+    ModelRegistry();
+    ModelRegistry(const ModelRegistry &) = delete;
+    ModelRegistry &operator=(const ModelRegistry &) = delete;
+
+    QStringList candidates(Kind kind) const;
+    cv::Ptr<cv::CascadeClassifier> loadCascade(Kind kind);
+    cv::Ptr<cv::face::Facemark> loadFacemark();
+    cv::Ptr<cv::CascadeClassifier> createCascade(Kind kind);
+    void record(Kind kind, const QString &path, double ms);
+
+    QThreadPool pool_; // 전역 풀과 분리(전역 풀 작업이 모델을 기다려도 교착 없음)
+    QString modelDir_;
+    QString configured_[int(Kind::Count)]; // 설정의 개별 경로(없으면 빈 문자열)
+
+    mutable QMutex mutex_;
+    bool started_ = false;
+    QFuture<cv::Ptr<cv::CascadeClassifier>> face_;
+    QFuture<cv::Ptr<cv::CascadeClassifier>> eye_;
+    QFuture<cv::Ptr<cv::face::Facemark>> facemark_;
+    Info info_[int(Kind::Count)];
+    std::shared_ptr<const std::string> xml_[int(Kind::Count)]; // 캐스케이드 원문(독립 인스턴스 구성용, 메모리에서 못 읽는 형식이면 nullptr)
+};
+
+template <typename T, typename F> void ModelRegistry::onReady(QObject *ctx, const QFuture<T> &future, F fn)
+{
+    auto *watcher = new QFutureWatcher<T>(ctx);
+    QObject::connect(watcher, &QFutureWatcher<T>::finished, ctx, [watcher, fn]() {
+        fn(watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(future);
+}
+
+#endif // MODELREGISTRY_H
@@ -1,9 +1,13 @@
 #include "photoeditpage.h"
 #include "QDateTime"
+#include "backgroundcolor.h"
 #include "main_app.h"
+#include "modelregistry.h"
+#include "suitcomposer.h"
 #include "ui_photoeditpage.h"
 #include <QDebug>
-#include <QStringList>
+#include <QSignalBlocker>
+#include <QtConcurrent>
 #include <algorithm>
 
 // ============================================================================
@@ -29,63 +33,19 @@ PhotoEditPage::PhotoEditPage(QWidget *parent) : QWidget(parent), ui(new Ui::Phot
     cv::Mat emptyMat;
     displayCurrentImage(emptyMat);
 
-    // 캐스케이드 분류기 로드 (절대경로) - 시스템에서 찾은 절대경로 사용
-    if (!faceCascade.load("/usr/local/share/opencv4/haarcascades/haarcascade_frontalface_default.xml"))
-    {
-        // 백업 경로도 시도
-        if (!faceCascade.load("/home/ubuntu/opencv/Intel7_simple_id_photo_maker/jinsu/haarcascade_frontalface_default.xml"))
-        {
-        }
-        else
-        {
-        }
-    }
-    else
-    {
-    }
-
-    // 모든 눈 캐스케이드 파일을 순차적으로 시도 (시스템 경로 우선)
-    QStringList eyeCascadePaths = {"/usr/local/share/opencv4/haarcascades/haarcascade_eye.xml", "/usr/local/share/opencv4/haarcascades/haarcascade_eye_tree_eyeglasses.xml", "/usr/local/share/opencv4/haarcascades/haarcascade_lefteye_2splits.xml",
-                                   "/usr/local/share/opencv4/haarcascades/haarcascade_righteye_2splits.xml", "/home/ubuntu/opencv/Intel7_simple_id_photo_maker/jinsu/haarcascade_eye_tree_eyeglasses.xml"};
-
-    bool eyeCascadeLoaded = false;
-    for (const QString &path : eyeCascadePaths)
-    {
-        if (eyeCascade.load(path.toStdString()))
-        {
-            eyeCascadeLoaded = true;
-            break;
-        }
-        else
-        {
-        }
-    }
-
-    if (!eyeCascadeLoaded)
-    {
-    }
-
-    // 얼굴 랜드마크 모델 초기화
-    facemark = cv::face::FacemarkLBF::create();
-
-    // 랜드마크 모델 파일 로드 (치아 미백에 필요) - 다운로드한 절대경로 사용
-    try
-    {
-        facemark->loadModel("/tmp/lbfmodel.yaml");
-    }
-    catch (const cv::Exception &e)
-    {
-        try
-        {
-            facemark->loadModel("/home/ubuntu/opencv/Intel7_simple_id_photo_maker/jinsu/lbfmodel.yaml");
-        }
-        catch (const cv::Exception &e2)
-        {
-        }
-    }
+    // 얼굴/눈/랜드마크 분석은 이미지마다 한 번, 전용 스레드에서(모델은 저장소가 백그라운드 로드)
+    analysisPool.setMaxThreadCount(1);
+    connect(&analysisWatcher, &QFutureWatcher<FaceAnalysis>::finished, this, &PhotoEditPage::onAnalysisFinished);
+    connect(&landmarkWatcher, &QFutureWatcher<FaceAnalysis>::finished, this, &PhotoEditPage::onLandmarksFinished);
 }
 
-PhotoEditPage::~PhotoEditPage() { delete ui; }
+/* 종료 시 분석을 기다리지 않음: 대기 중 작업은 버리고, 실행 중 작업은 다음 단계에서 멈추게 함(모델 대기는 이 객체의 감시자와 함께 사라짐) */
+PhotoEditPage::~PhotoEditPage()
+{
+    analysisPool.clear();
+    analyzer->cancel();
+    delete ui;
+}
 
 void PhotoEditPage::setMainApp(main_app *app)
 {
@@ -103,18 +63,124 @@ void PhotoEditPage::setMainApp(main_app *app)
 
 void PhotoEditPage::loadImage(const QString &path)
 {
-    originalImage = cv::imread(path.toStdString());
+    // 알파가 있는 PNG(RGBA 합성 결과)는 매트를 유지한 채 현재 배경색으로 평탄화
+    const cv::Mat image = cv::imread(path.toStdString(), cv::IMREAD_UNCHANGED);
+    if (image.type() == CV_8UC4)
+    {
+        cv::Mat alpha;
+        cv::extractChannel(image, alpha, 3);
+        loadImage(SuitComposer::flattenRGBA(image, currentBackgroundColor), alpha, currentBackgroundColor);
+        return;
+    }
+    loadImage(cv::imread(path.toStdString()));
+}
 
-    if (originalImage.empty())
+// 촬영 직후 합성 결과를 메모리로 전달받음(알파 매트 포함, 디스크 왕복 없음)
+// bgColor: imageBGR이 평탄화된 배경색. 알파가 있으면 배경색 변경은 재분할 없이 한 번의 혼합
+void PhotoEditPage::loadImage(const cv::Mat &imageBGR, const cv::Mat &alpha, const cv::Scalar &bgColor)
+{
+    if (imageBGR.empty())
     {
         return;
     }
 
+    originalImage = imageBGR;
+    originalAlpha = alpha.size() == imageBGR.size() ? alpha : cv::Mat();
+    capturedBackgroundColor = bgColor;
+    currentBackgroundColor = bgColor;
+    selectBackgroundText(bgColor);
+    createBackgroundWithColor(currentBackgroundColor);
     currentImage = originalImage.clone();
+    effectImage = originalImage;
     spotSmoothImage = originalImage.clone();
+    startAnalysis();
     displayCurrentImage(currentImage);
 }
 
+/*
+ * originalImage 분석 시작(이전 결과 폐기). 새 이미지가 들어올 때만: 보정/반전은 기하를 바꾸지 않음
+ * 모델 로드는 GUI 이벤트로 기다림: 얼굴/눈 캐스케이드가 준비되면 검출, 랜드마크는 그 뒤 따로(느린 모델이 눈 보정을 막지 않게)
+ */
+void PhotoEditPage::startAnalysis()
+{
+    analysis = FaceAnalysis();
+    mouthMask.release();
+    const int serial = ++analysisSerial;
+    ModelRegistry &models = ModelRegistry::instance();
+    const QFuture<cv::Ptr<cv::CascadeClassifier>> eyeFuture = models.eyeCascade();
+    ModelRegistry::onReady(this, models.faceCascade(), [this, serial, eyeFuture](const cv::Ptr<cv::CascadeClassifier> &) {
+        ModelRegistry::onReady(this, eyeFuture, [this, serial](const cv::Ptr<cv::CascadeClassifier> &) { runFaceDetection(serial); });
+    });
+}
+
+void PhotoEditPage::runFaceDetection(int serial)
+{
+    if (serial != analysisSerial)
+        return; // 그사이 다른 이미지가 들어옴
+    const cv::Mat image = originalImage;
+    const std::shared_ptr<FaceAnalyzer> worker = analyzer;
+    analysisWatcher.setFuture(QtConcurrent::run(&analysisPool, [image, worker, serial] {
+        FaceAnalysis a = worker->analyze(image);
+        a.serial = serial;
+        return a;
+    }));
+}
+
+void PhotoEditPage::onAnalysisFinished()
+{
+    FaceAnalysis a = analysisWatcher.result();
+    if (a.serial != analysisSerial || a.imageSize != originalImage.size())
+        return; // 그사이 다른 이미지가 들어옴
+    analysis = std::move(a);
+
+    if (analysis.hasFace())
+    {
+        const int serial = analysis.serial;
+        ModelRegistry::onReady(this, ModelRegistry::instance().facemark(), [this, serial](const cv::Ptr<cv::face::Facemark> &) { startLandmarks(serial); });
+    }
+
+    // 분석 대기 중에 적용 못 한 눈 크기 보정 반영
+    if (eyeSizeStrength > 0)
+        applyAllEffects();
+}
+
+void PhotoEditPage::startLandmarks(int serial)
+{
+    if (serial != analysisSerial || !analysis.hasFace())
+        return;
+    const cv::Mat image = originalImage;
+    const cv::Rect face = analysis.face;
+    const std::shared_ptr<FaceAnalyzer> worker = analyzer;
+    landmarkWatcher.setFuture(QtConcurrent::run(&analysisPool, [image, face, worker, serial] {
+        FaceAnalysis a;
+        a.imageSize = image.size();
+        a.serial = serial;
+        a.landmarks = worker->fitLandmarks(image, face);
+        return a;
+    }));
+}
+
+void PhotoEditPage::onLandmarksFinished()
+{
+    FaceAnalysis a = landmarkWatcher.result();
+    if (a.serial != analysisSerial || a.imageSize != originalImage.size())
+        return;
+    analysis.landmarks = std::move(a.landmarks);
+
+    // 치아 미백 영역: 68점 랜드마크의 안쪽 입술(60~67)을 얼굴 크기에 맞춰 조금 넓히고 가장자리를 흐림
+    if (analysis.landmarks.size() >= 68)
+    {
+        std::vector<cv::Point> lips;
+        for (int i = 60; i < 68; ++i)
+            lips.emplace_back(cvRound(analysis.landmarks[i].x), cvRound(analysis.landmarks[i].y));
+        mouthMask = cv::Mat::zeros(originalImage.size(), CV_8UC1);
+        cv::fillConvexPoly(mouthMask, lips, cv::Scalar(255));
+        const int grow = std::max(1, analysis.face.width / 40);
+        cv::dilate(mouthMask, mouthMask, cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(2 * grow + 1, 2 * grow + 1)));
+        cv::GaussianBlur(mouthMask, mouthMask, cv::Size(), grow);
+    }
+}
+
 cv::Mat PhotoEditPage::displayCurrentImage(cv::Mat &image)
 {
     cv::Mat display_image;
@@ -169,6 +235,20 @@ cv::Mat PhotoEditPage::displayCurrentImage(cv::Mat &image)
 
 cv::Mat PhotoEditPage::getCurrentImage() const { return currentImage; }
 
+
+cv::Mat PhotoEditPage::getCurrentAlpha() const
+{
+    if (originalAlpha.empty() || !isHorizontalFlipped)
+        return originalAlpha;
+    cv::Mat flipped;
+    cv::flip(originalAlpha, flipped, 1);
+    return flipped;
+}
+
+cv::Scalar PhotoEditPage::getBackgroundColor() const { return currentBackgroundColor; }
+
+bool PhotoEditPage::isGrayscale() const { return isBWMode; }
+
 // ============================================================================
 // EFFECT APPLICATION
 // ============================================================================
@@ -188,47 +268,49 @@ void PhotoEditPage::applyAllEffects()
         sharpen(currentImage, sharpnessStrength);
     }
 
-    // 눈 크기 조정 적용 (얼굴 검출 필요)
-    if (eyeSizeStrength > 0)
+    // 눈 크기 조정 적용(이미지 로드 때 한 번 계산한 얼굴/눈 분석 사용, 분석이 끝나면 다시 적용됨)
+    if (eyeSizeStrength > 0 && analysis.hasFace())
     {
-        if (faceCascade.empty())
-        {
-        }
-        else
-        {
-            std::vector<cv::Rect> faces;
-            cv::Mat gray;
-            cv::cvtColor(currentImage, gray, cv::COLOR_BGR2GRAY);
-            cv::equalizeHist(gray, gray);
-            faceCascade.detectMultiScale(gray, faces, 1.1, 5, 0, cv::Size(80, 80));
-
-            if (!faces.empty())
-            {
-                cv::Rect face_roi = safeRect(faces[0].x, faces[0].y, faces[0].width, faces[0].height, currentImage.cols, currentImage.rows);
-                if (!face_roi.empty())
-                {
-                    correctEyes(currentImage, face_roi, eyeSizeStrength);
-                }
-            }
-            else
-            {
-            }
-        }
+        correctEyes(currentImage, analysis, eyeSizeStrength);
     }
 
     // 치아 미백은 이제 수동으로만 적용 (마우스 클릭 시)
 
+    effectImage = currentImage;
+    applyFinishingEffects();
+}
+
+/* 보정 결과에 배경색 교체 → 흑백 → 반전 후 표시(배경색만 바뀔 때는 이것만 다시 수행) */
+void PhotoEditPage::applyFinishingEffects()
+{
+    if (effectImage.empty())
+    {
+        return;
+    }
+
+    // 합성 알파가 있으면 실제 사진 배경을 교체(없으면 여백 색만 바뀜)
+    cv::Mat finished;
+    if (!originalAlpha.empty())
+    {
+        SuitComposer::rebaseBackground(effectImage, originalAlpha, capturedBackgroundColor, currentBackgroundColor, finished);
+    }
+    else
+    {
+        finished = effectImage.clone();
+    }
+
     if (isBWMode)
     {
-        cv::cvtColor(currentImage, currentImage, cv::COLOR_BGR2GRAY);
-        cv::cvtColor(currentImage, currentImage, cv::COLOR_GRAY2BGR);
+        cv::cvtColor(finished, finished, cv::COLOR_BGR2GRAY);
+        cv::cvtColor(finished, finished, cv::COLOR_GRAY2BGR);
     }
 
     if (isHorizontalFlipped)
     {
-        cv::flip(currentImage, currentImage, 1);
+        cv::flip(finished, finished, 1);
     }
 
+    currentImage = finished;
     displayCurrentImage(currentImage);
 }
 
@@ -326,12 +408,13 @@ cv::Rect PhotoEditPage::safeRect(int x, int y, int w, int h, int maxW, int maxH)
     return r;
 }
 
-void PhotoEditPage::correctEyes(cv::Mat &image, cv::Rect roi, int strength)
+// face: image와 같은 좌표의 분석 결과(로드 때 검출한 얼굴/눈)
+void PhotoEditPage::correctEyes(cv::Mat &image, const FaceAnalysis &face, int strength)
 {
     if (strength <= 0 || image.empty())
         return;
 
-    if (eyeCascade.empty())
+    if (!face.eyeModel)
     {
         return;
     }
@@ -340,7 +423,7 @@ void PhotoEditPage::correctEyes(cv::Mat &image, cv::Rect roi, int strength)
     if (enlargement_factor <= 0)
         return;
 
-    cv::Rect safe_face = safeRect(roi.x, roi.y, roi.width, roi.height, image.cols, image.rows);
+    cv::Rect safe_face = safeRect(face.face.x, face.face.y, face.face.width, face.face.height, image.cols, image.rows);
     if (safe_face.empty())
         return;
 
@@ -352,12 +435,10 @@ void PhotoEditPage::correctEyes(cv::Mat &image, cv::Rect roi, int strength)
     if (roi_img.empty())
         return;
 
+    // 검출된 눈(이미지 좌표 → 얼굴 상단 ROI 좌표)
     std::vector<cv::Rect> eyes;
-    cv::Mat gray;
-    cv::cvtColor(roi_img, gray, cv::COLOR_BGR2GRAY);
-    cv::equalizeHist(gray, gray);
-    // 더 완화된 눈 검출 파라미터 시도
-    eyeCascade.detectMultiScale(gray, eyes, 1.05, 2, 0, cv::Size(10, 10), cv::Size(100, 100));
+    for (const cv::Rect &e : face.eyes)
+        eyes.push_back(e - upper_face_roi.tl());
 
     // 눈이 검출되지 않으면 가상의 눈 위치를 추정
     if (eyes.size() < 1)
@@ -587,6 +668,10 @@ void PhotoEditPage::applyTeethWhitening(cv::Mat &image, const cv::Point &center,
     // 마스크 부드럽게 처리
     cv::GaussianBlur(mask, mask, cv::Size(9, 9), 3);
 
+    // 랜드마크가 있으면 입 안쪽만(입술/피부에 번지지 않게)
+    if (mouthMask.size() == image.size())
+        cv::multiply(mask, mouthMask(roi), mask, 1.0 / 255.0);
+
     // --- 치아 미백 처리 ---
     float whitening_strength = 8.0f; // 미백 강도
     float yellow_reduction = 6.0f;   // 노란기 제거 강도
@@ -683,6 +768,10 @@ void PhotoEditPage::mousePressEvent(QMouseEvent *event)
                 // 이미지 경계 확인
                 if (imageX >= 0 && imageY >= 0 && imageX < originalImage.cols && imageY < originalImage.rows)
                 {
+                    // 보정은 뒤집기 전 원본 좌표계에 적용되므로 화면 좌표를 되돌림
+                    if (isHorizontalFlipped)
+                        imageX = originalImage.cols - 1 - imageX;
+
                     drawing = true;
                     lastPoint = cv::Point(imageX, imageY);
 
@@ -743,6 +832,9 @@ void PhotoEditPage::mouseMoveEvent(QMouseEvent *event)
 
             if (imageX >= 0 && imageY >= 0 && imageX < originalImage.cols && imageY < originalImage.rows)
             {
+                if (isHorizontalFlipped)
+                    imageX = originalImage.cols - 1 - imageX;
+
                 cv::Point current(imageX, imageY);
                 int dx = abs(current.x - lastPoint.x);
                 int dy = abs(current.y - lastPoint.y);
@@ -859,34 +951,26 @@ cv::Mat PhotoEditPage::overlayPhotoOnBackground(const cv::Mat &photo, const cv::
     return result; // 배경 + 사진 합성 결과 반환
 }
 
+// 배경색 → 콤보박스 표시 동기화(슬롯은 호출하지 않음)
+void PhotoEditPage::selectBackgroundText(const cv::Scalar &color)
+{
+    const QSignalBlocker blocker(ui->comboBox_background);
+    ui->comboBox_background->setCurrentText(BackgroundColor::nameOf(color));
+}
+
 // 배경색 콤보박스 이벤트 핸들러
 void PhotoEditPage::on_comboBox_background_currentTextChanged(const QString &text)
 {
     // 미리 정의된 배경색 설정 (BGR 순서)
-    if (text == "흰색")
-    {
-        currentBackgroundColor = cv::Scalar(255, 255, 255); // 흰색
-    }
-    else if (text == "파란색")
-    {
-        currentBackgroundColor = cv::Scalar(255, 0, 0); // 파란색
-    }
-    else if (text == "빨간색")
-    {
-        currentBackgroundColor = cv::Scalar(0, 0, 255); // 빨간색
-    }
-    else if (text == "회색")
-    {
-        currentBackgroundColor = cv::Scalar(128, 128, 128); // 회색
-    }
+    currentBackgroundColor = BackgroundColor::fromName(text, currentBackgroundColor);
 
     // 배경 이미지 새로 생성
     createBackgroundWithColor(currentBackgroundColor);
 
-    // 현재 이미지가 있으면 applyAllEffects, 없으면 배경만 표시
+    // 현재 이미지가 있으면 배경 교체 후 표시(보정 효과는 다시 계산하지 않음), 없으면 배경만 표시
     if (!originalImage.empty())
     {
-        applyAllEffects();
+        applyFinishingEffects();
     }
     else
     {
@@ -897,11 +981,10 @@ void PhotoEditPage::on_comboBox_background_currentTextChanged(const QString &tex
 
 void PhotoEditPage::on_retakeshot_button_clicked()
 {
-    // main_app으로 돌아가서 재촬영
+    // main_app으로 돌아가서 재촬영(진행 중 합성은 취소)
     if (mainApp)
     {
-        this->hide();
-        mainApp->show();
+        mainApp->retake();
     }
 }
 
@@ -931,6 +1014,7 @@ void PhotoEditPage::on_init_button_clicked()
     // 배경색을 기본 흰색으로 설정
     // 배경색을 흰색으로 초기화 중...
     currentBackgroundColor = cv::Scalar(255, 255, 255); // 화이트 (BGR)
+    selectBackgroundText(currentBackgroundColor);
     createBackgroundWithColor(currentBackgroundColor);
 
     // 마우스 커서를 기본 상태로 복원
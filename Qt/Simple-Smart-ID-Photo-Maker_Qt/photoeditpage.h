@@ -1,11 +1,14 @@
 #ifndef PHOTOEDITPAGE_H
 #define PHOTOEDITPAGE_H
 
+#include "faceanalysis.h"
+#include <QFutureWatcher>
+#include <QThreadPool>
 #include <QWidget>
 #include <QMouseEvent>
 #include <QResizeEvent>
 #include <opencv2/opencv.hpp>
-#include <opencv2/face.hpp>
+#include <memory>
 
 class main_app;
 
@@ -22,13 +25,19 @@ public:
     ~PhotoEditPage();
     void setMainApp(main_app* app);
     cv::Mat getCurrentImage() const;
+    // currentImage와 같은 좌표의 합성 알파(없으면 빈 Mat), 선택된 배경색, 흑백 여부(흑백이면 배경도 회색조로 적용됨)
+    cv::Mat getCurrentAlpha() const;
+    cv::Scalar getBackgroundColor() const;
+    bool isGrayscale() const;
 
 
 private:
     Ui::PhotoEditPage *ui;
     main_app* mainApp;
     cv::Mat originalImage;
+    cv::Mat originalAlpha; // 합성 알파 매트(파일에서 불러온 경우 비어 있음)
     cv::Mat currentImage;
+    cv::Mat effectImage;  // 보정 효과까지 적용(배경 교체/흑백/반전 전)
 
     bool isBWMode = false;
     bool isHorizontalFlipped = false;
@@ -37,20 +46,31 @@ private:
     bool isSpotRemovalMode = false;
     cv::Mat spotSmoothImage;
 
+    // originalImage 얼굴 분석(새 이미지에서만 다시 계산, 눈 크기 보정/치아 미백이 재사용)
+    FaceAnalysis analysis;
+    cv::Mat mouthMask; // 랜드마크 안쪽 입술 영역(originalImage 크기 8U, 가장자리 흐림). 없으면 미백 영역 제한 없음
+    int analysisSerial = 0;
+    std::shared_ptr<FaceAnalyzer> analyzer = std::make_shared<FaceAnalyzer>(); // 분석 스레드 전용 검출기
+    QThreadPool analysisPool; // 스레드 1개: 분석을 순서대로(검출기를 동시에 쓰지 않음)
+    QFutureWatcher<FaceAnalysis> analysisWatcher; // 얼굴/눈
+    QFutureWatcher<FaceAnalysis> landmarkWatcher; // 랜드마크만 채운 결과
+
     bool isTeethWhiteningMode = false;
 
     // 배경색 관련 변수
     cv::Scalar currentBackgroundColor = cv::Scalar(255, 255, 255); // 기본 흰색 (BGR)
+    cv::Scalar capturedBackgroundColor = cv::Scalar(255, 255, 255); // originalImage가 평탄화된 배경색
     cv::Mat backgroundImage;
 
-    cv::CascadeClassifier faceCascade;
-    cv::CascadeClassifier eyeCascade;
-    cv::Ptr<cv::face::Facemark> facemark;
-
     cv::Mat displayCurrentImage(cv::Mat& image);
     void applyAllEffects();
+    void applyFinishingEffects(); // effectImage → 배경색 교체, 흑백, 반전 → 표시
+    void startAnalysis();
+    void runFaceDetection(int serial);
+    void startLandmarks(int serial);
+    void selectBackgroundText(const cv::Scalar &color);
     void sharpen(cv::Mat& image, int strength);
-    void correctEyes(cv::Mat& image, cv::Rect roi, int strength);
+    void correctEyes(cv::Mat& image, const FaceAnalysis& face, int strength);
     cv::Rect safeRect(int x, int y, int w, int h, int maxW, int maxH);
     void applySmoothSpot(cv::Mat& image, const cv::Point& center, int radius);
     void applyInpaintSpot(cv::Mat& image, const cv::Point& center, int radius);
@@ -70,7 +90,10 @@ private:
 
 public slots:
     void loadImage(const QString& imagePath);
+    void loadImage(const cv::Mat& imageBGR, const cv::Mat& alpha = cv::Mat(), const cv::Scalar& bgColor = cv::Scalar(255, 255, 255));
 private slots:
+    void onAnalysisFinished();
+    void onLandmarksFinished();
     void on_BW_Button_clicked(bool checked);
     void on_horizontal_flip_button_clicked();
     void on_Sharpen_bar_actionTriggered(int action);
@@ -0,0 +1,142 @@
+#include "pipelinebench.h"
+#include "facetracker.h"
+#include "framesource.h"
+#include "guidedfilter.h"
+#include "suitcomposer.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+/* 측정값 요약 출력: 평균/중앙값/p95/최대(ms) */
+static void printStats(const char *name, std::vector<double> v)
+{
+    if (v.empty())
+        return;
+    std::sort(v.begin(), v.end());
+    double sum = 0;
+    for (double x : v)
+        sum += x;
+    const auto at = [&](double q) { return v[std::min(v.size() - 1, size_t(q * (v.size() - 1) + 0.5))]; };
+    std::printf("[bench] %-12s n=%-5zu mean=%7.3f p50=%7.3f p95=%7.3f max=%7.3f ms\n", name, v.size(), sum / v.size(), at(0.5), at(0.95), v.back());
+}
+
+static double elapsedMs(const QElapsedTimer &t) { return t.nsecsElapsed() / 1e6; }
+
+int runPipelineBench(const QString &sourceSpec, int frames, int composeEvery)
+{
+    std::unique_ptr<FrameSource> source = FrameSource::create(sourceSpec.isEmpty() ? QString("synthetic") : sourceSpec);
+    if (!source || !source->open())
+    {
+        std::fprintf(stderr, "[error] frame source open fail: %s\n", qPrintable(sourceSpec));
+        return 2;
+    }
+    std::printf("[bench] source: %s, frames: %d\n", qPrintable(source->describe()), frames);
+
+    // 앱과 동일한 합성 설정
+    SuitComposer comp;
+    comp.setCanvas(300, 400, 290);
+    SuitAssets assets = SuitComposer::loadAssets("../../image/man_suit_bg_remove.png", "../../image/man_suit_bg_remove.png", cv::Size(300, 400));
+    FaceTracker tracker;
+    if (!assets.trackerDet.empty())
+        tracker.setDetector(assets.trackerDet);
+    if (!comp.setAssets(std::move(assets)))
+    {
+        std::fprintf(stderr, "[error] suit load fail\n");
+        return 1;
+    }
+    comp.setMirror(true);
+    comp.setGuideVisible(true);
+    comp.setGuideOpacity(0.7);
+
+    std::vector<double> readMs, trackMs, previewMs, composeMs, composeFullMs, composeCvMs, segmentMs, segmentCvMs, segmentIters;
+    std::vector<double> refineGuidedMs, refineMorphMs;
+    CapturedFrame frame;
+    cv::Mat preview; // 앱과 같이 출력 버퍼 재사용
+    QElapsedTimer t;
+    for (int i = 0; i < frames; ++i)
+    {
+        t.start();
+        if (!source->read(frame))
+        {
+            std::fprintf(stderr, "[warn] read fail at frame %d\n", i);
+            break;
+        }
+        readMs.push_back(elapsedMs(t));
+
+        if (tracker.hasDetector())
+            trackMs.push_back(tracker.update(frame.bgr).ms);
+
+        t.start();
+        comp.makePreview(frame.bgr, preview);
+        previewMs.push_back(elapsedMs(t));
+
+        if (composeEvery > 0 && i % composeEvery == 0)
+        {
+            const cv::Mat full = frame.fullResBGR();
+            // 분할 방식별 비교(기본 ROI 다중 해상도 / 캔버스 전체 / cv::grabCut 엔진)
+            comp.setSegmentMode(SuitComposer::SegmentMode::RoiMultiRes);
+            t.start();
+            cv::Mat out = comp.composeBGR(full);
+            composeMs.push_back(elapsedMs(t));
+            segmentMs.push_back(comp.lastSegmentStats().ms);
+            segmentIters.push_back(comp.lastSegmentStats().iterations);
+
+            comp.setSegmentMode(SuitComposer::SegmentMode::FullGrabCut);
+            t.start();
+            out = comp.composeBGR(full);
+            composeFullMs.push_back(elapsedMs(t));
+
+            comp.setSegmentMode(SuitComposer::SegmentMode::RoiMultiRes);
+            comp.setSegmentEngine(SuitComposer::SegmentEngine::OpenCv);
+            t.start();
+            out = comp.composeBGR(full);
+            composeCvMs.push_back(elapsedMs(t));
+            segmentCvMs.push_back(comp.lastSegmentStats().ms);
+            comp.setSegmentEngine(SuitComposer::SegmentEngine::Parallel);
+
+            // 경계 정리 비교(캔버스 크기): composeRGBA의 refineMatte(같은 반경/eps) / 이전 이진화 → CLOSE → ERODE
+            cv::Mat view, gray, alpha, refined;
+            cv::resize(frame.bgr, view, cv::Size(300, 400), 0, 0, cv::INTER_AREA);
+            cv::cvtColor(view, gray, cv::COLOR_BGR2GRAY);
+            alpha = cv::Mat::zeros(view.size(), CV_8U);
+            cv::ellipse(alpha, cv::Point(150, 190), cv::Size(90, 120), 0, 0, 360, cv::Scalar(255), cv::FILLED);
+            cv::GaussianBlur(alpha, alpha, cv::Size(5, 5), 0);
+            constexpr int kRefineReps = 20; // 한 번은 너무 짧아 반복 평균
+            t.start();
+            for (int r = 0; r < kRefineReps; ++r)
+                refined = GuidedFilter::refineMatte(gray, alpha, 4, 1e-3);
+            refineGuidedMs.push_back(elapsedMs(t) / kRefineReps);
+            const cv::Mat k3 = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(3, 3));
+            t.start();
+            for (int r = 0; r < kRefineReps; ++r)
+            {
+                cv::threshold(alpha, refined, 127, 255, cv::THRESH_BINARY);
+                cv::morphologyEx(refined, refined, cv::MORPH_CLOSE, k3, cv::Point(-1, -1), 1);
+                cv::erode(refined, refined, k3, cv::Point(-1, -1), 1);
+            }
+            refineMorphMs.push_back(elapsedMs(t) / kRefineReps);
+        }
+    }
+
+    printStats("read", readMs);
+    printStats("face-track", trackMs);
+    if (tracker.hasDetector())
+        std::printf("[bench] %-12s full=%d roi=%d\n", "face-detect", tracker.fullDetections(), tracker.roiDetections());
+    printStats("preview", previewMs);
+    printStats("compose", composeMs);
+    printStats("compose-full", composeFullMs);
+    printStats("compose-cv", composeCvMs);
+    printStats("segment", segmentMs);
+    printStats("segment-cv", segmentCvMs);
+    printStats("refine-gf", refineGuidedMs);
+    printStats("refine-morph", refineMorphMs);
+    if (!segmentIters.empty())
+    {
+        double sum = 0;
+        for (double x : segmentIters)
+            sum += x;
+        std::printf("[bench] %-12s mean=%.2f\n", "seg-iters", sum / segmentIters.size());
+    }
+    return 0;
+}
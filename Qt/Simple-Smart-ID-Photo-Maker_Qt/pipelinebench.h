@@ -0,0 +1,13 @@
+#ifndef PIPELINEBENCH_H
+#define PIPELINEBENCH_H
+
+#include <QString>
+
+/*
+ * 헤드리스 파이프라인 벤치마크
+ * - FrameSource 스펙(기본 synthetic)으로 프레임을 읽어 makePreviewBGR/composeBGR 시간을 측정
+ * - 창/카메라 없이 재현 가능하게 실행: --bench <프레임 수> [--source <스펙>]
+ */
+int runPipelineBench(const QString &sourceSpec, int frames, int composeEvery = 30);
+
+#endif // PIPELINEBENCH_H
@@ -0,0 +1,99 @@
+#include "previewscheduler.h"
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+// 낮은 단계일수록 고품질
+const PreviewScheduler::Mode kModes[] = {
+    {0, 0, 1.0, SuitComposer::GuideStyle::Blend},
+    {1, 0, 1.0, SuitComposer::GuideStyle::Outline},
+    {2, 0, 0.5, SuitComposer::GuideStyle::Outline},
+    {3, 15, 0.5, SuitComposer::GuideStyle::Outline},
+    {4, 10, 0.5, SuitComposer::GuideStyle::Outline},
+};
+constexpr double kEmaAlpha = 0.2;
+constexpr int kDegradeAfter = 5;      // 연속 초과 프레임 수
+constexpr int kUpgradeAfter = 60;     // 연속 여유 프레임 수
+constexpr double kUpgradeRatio = 0.5; // 예산의 이 비율 아래면 여유
+} // namespace
+
+QString PreviewScheduler::Mode::describe() const
+{
+    return QString("level %1: %2, %3%, guide %4")
+        .arg(level)
+        .arg(maxFps > 0 ? QString("%1fps").arg(maxFps) : QString("every frame"))
+        .arg(int(scale * 100))
+        .arg(guide == SuitComposer::GuideStyle::Blend ? "blend" : "outline");
+}
+
+PreviewScheduler::PreviewScheduler(QObject *parent) : QObject(parent), mode_(kModes[0]) {}
+
+int PreviewScheduler::levelCount() { return int(std::size(kModes)); }
+
+void PreviewScheduler::setBudgetMs(double ms)
+{
+    budgetMs_ = std::max(1.0, ms);
+    overFrames_ = underFrames_ = 0;
+}
+
+/* 속도 제한 단계: 마지막으로 그린 뒤 1/maxFps가 지났을 때만 허용 */
+bool PreviewScheduler::admit(std::chrono::steady_clock::time_point now)
+{
+    if (mode_.maxFps > 0 && now - lastAdmit_ < std::chrono::microseconds(1000000 / mode_.maxFps))
+        return false;
+    lastAdmit_ = now;
+    return true;
+}
+
+void PreviewScheduler::record(Stage stage, double ms)
+{
+    const size_t i = size_t(stage);
+    if (!seeded_[i])
+    {
+        ema_[i] = ms;
+        seeded_[i] = true;
+    }
+    else
+        ema_[i] += kEmaAlpha * (ms - ema_[i]);
+}
+
+double PreviewScheduler::frameMs() const
+{
+    double sum = 0;
+    for (double v : ema_)
+        sum += v;
+    return sum;
+}
+
+/* 예산 대비 비용으로 단계 조정(히스테리시스: 빨리 낮추고 천천히 올림) */
+void PreviewScheduler::endFrame()
+{
+    // 속도 제한 단계에서는 프레임 간격 안에만 끝나면 밀리지 않음
+    const double cost = frameMs();
+    const double budget = mode_.maxFps > 0 ? std::max(budgetMs_, 800.0 / mode_.maxFps) : budgetMs_;
+    if (cost > budget)
+    {
+        underFrames_ = 0;
+        if (++overFrames_ >= kDegradeAfter && mode_.level + 1 < levelCount())
+            setLevel(mode_.level + 1, cost);
+    }
+    else if (cost < budgetMs_ * kUpgradeRatio)
+    {
+        overFrames_ = 0;
+        if (++underFrames_ >= kUpgradeAfter && mode_.level > 0)
+            setLevel(mode_.level - 1, cost);
+    }
+    else
+        overFrames_ = underFrames_ = 0;
+}
+
+/* 모드 변경: 새 모드의 비용을 다시 재도록 평균 초기화 */
+void PreviewScheduler::setLevel(int level, double costMs)
+{
+    mode_ = kModes[level];
+    overFrames_ = underFrames_ = 0;
+    seeded_.fill(false);
+    ema_.fill(0.0);
+    emit modeChanged(mode_, costMs);
+}
@@ -0,0 +1,71 @@
+#ifndef PREVIEWSCHEDULER_H
+#define PREVIEWSCHEDULER_H
+
+#include "suitcomposer.h"
+#include <QObject>
+#include <array>
+#include <chrono>
+
+/*
+ * 프리뷰 프레임 예산 스케줄러(GUI 스레드)
+ * - 단계별 비용(디코드/프리뷰 생성/QImage 변환/그리기)을 지수 이동 평균으로 측정
+ * - 합계가 예산을 계속 넘으면 한 단계 낮추고, 충분히 여유가 있으면 한 단계 올림
+ * - 단계: 가이드 품질(합성 → 외곽선) → 프리뷰 해상도(1/2) → 프리뷰 속도(15/10fps) 순으로 낮춤
+ */
+class PreviewScheduler : public QObject
+{
+    Q_OBJECT
+  public:
+    enum class Stage
+    {
+        Decode,  // 공급원 디코드(캡처 스레드)
+        Track,   // 얼굴 추적(FaceTracker::update)
+        Preview, // makePreviewBGR
+        Convert, // Mat → QImage/QPixmap
+        Paint,   // 위젯 그리기
+        Count
+    };
+
+    struct Mode
+    {
+        int level = 0;
+        int maxFps = 0;      // 0 = 제한 없음(새 프레임마다)
+        double scale = 1.0;  // 캔버스 대비 프리뷰 배율
+        SuitComposer::GuideStyle guide = SuitComposer::GuideStyle::Blend;
+        QString describe() const;
+    };
+
+    explicit PreviewScheduler(QObject *parent = nullptr);
+
+    void setBudgetMs(double ms); // 목표 프레임 비용(기본 30ms)
+    double budgetMs() const { return budgetMs_; }
+
+    const Mode &mode() const { return mode_; }
+    static int levelCount();
+
+    // 이번 프레임을 그릴지(속도 제한 단계에서는 간격이 안 되면 false)
+    bool admit(std::chrono::steady_clock::time_point now);
+    void record(Stage stage, double ms);
+    // 한 프레임 측정이 끝난 뒤 호출 → 필요 시 모드 변경
+    void endFrame();
+
+    double stageMs(Stage stage) const { return ema_[size_t(stage)]; }
+    double frameMs() const; // 단계 평균 합
+
+  signals:
+    // costMs: 변경 직전 측정된 프레임 비용
+    void modeChanged(const PreviewScheduler::Mode &mode, double costMs);
+
+  private:
+    void setLevel(int level, double costMs);
+
+    double budgetMs_ = 30.0;
+    Mode mode_;
+    std::array<double, size_t(Stage::Count)> ema_{};
+    std::array<bool, size_t(Stage::Count)> seeded_{};
+    int overFrames_ = 0;  // 예산 초과 연속 프레임
+    int underFrames_ = 0; // 여유 연속 프레임
+    std::chrono::steady_clock::time_point lastAdmit_;
+};
+
+#endif // PREVIEWSCHEDULER_H
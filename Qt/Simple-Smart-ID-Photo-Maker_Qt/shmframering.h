@@ -0,0 +1,58 @@
+#ifndef SHMFRAMERING_H
+#define SHMFRAMERING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * POSIX 공유 메모리 프레임 링 레이아웃(외부 캡처 프로세스 → 앱)
+ * - Qt 의존 없음: 앱(ShmRingFrameSource)과 쓰기 도구(shm_frame_writer)가 함께 사용
+ * - [Header][슬롯 0][슬롯 1]... 슬롯 = [SlotHeader][픽셀(stride * height)], 모두 64바이트 정렬
+ * - 생산자 1개가 프레임 n(1부터)을 슬롯 (n-1) % slotCount에 쓰고 latest = n으로 공개
+ * - 슬롯 seq는 seqlock: 쓰는 중 2n-1(홀수), 완료 시 2n(짝수)
+ * - 소비자는 seq가 2n인 최신 슬롯을 복사한 뒤 seq를 다시 확인(그사이 바뀌었으면 찢어진 프레임 → 버리고 재시도)
+ * - 생산자는 시작할 때 같은 이름을 unlink 후 새로 만듦 → 소비자는 이름이 다른 객체를 가리키면 다시 매핑
+ */
+namespace shmring
+{
+constexpr std::uint32_t kMagic = 0x52504449; // "IDPR"
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kAlign = 64;
+
+struct alignas(kAlign) Header
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t slotCount;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t cvType; // CV_8UC3(BGR) 권장, CV_8UC1/CV_8UC4도 허용
+    std::uint32_t stride; // 행 간격(바이트)
+    std::uint32_t reserved;
+    std::uint64_t slotBytes;          // 슬롯 간격(SlotHeader 포함)
+    std::atomic<std::uint64_t> latest; // 마지막으로 완료된 프레임 번호(0 = 아직 없음)
+};
+
+struct alignas(kAlign) SlotHeader
+{
+    std::atomic<std::uint64_t> seq; // seqlock
+    std::uint64_t frame;            // 프레임 번호
+    std::int64_t timestampNs;       // 생산자 CLOCK_MONOTONIC 시각
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+
+inline std::size_t alignUp(std::size_t n) { return (n + kAlign - 1) & ~(kAlign - 1); }
+inline std::size_t slotBytes(std::size_t stride, std::size_t height) { return alignUp(sizeof(SlotHeader)) + alignUp(stride * height); }
+inline std::size_t totalBytes(std::size_t slotCount, std::size_t slotBytes) { return alignUp(sizeof(Header)) + slotCount * slotBytes; }
+
+inline SlotHeader *slotAt(void *base, const Header &h, std::uint64_t frame)
+{
+    const std::size_t index = std::size_t((frame - 1) % h.slotCount);
+    return reinterpret_cast<SlotHeader *>(static_cast<unsigned char *>(base) + alignUp(sizeof(Header)) + index * h.slotBytes);
+}
+inline unsigned char *pixels(SlotHeader *slot) { return reinterpret_cast<unsigned char *>(slot) + alignUp(sizeof(SlotHeader)); }
+} // namespace shmring
+
+#endif // SHMFRAMERING_H
@@ -0,0 +1,130 @@
+#include "shmringframesource.h"
+#include <QDebug>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+ShmRingFrameSource::ShmRingFrameSource(const QString &name) : name_(name.startsWith('/') ? name : "/" + name) {}
+
+ShmRingFrameSource::~ShmRingFrameSource() { close(); }
+
+void ShmRingFrameSource::close()
+{
+    if (base_)
+        munmap(base_, mappedBytes_);
+    base_ = nullptr;
+    header_ = nullptr;
+    mappedBytes_ = 0;
+}
+
+bool ShmRingFrameSource::open()
+{
+    close();
+    return attach();
+}
+
+/* 공유 메모리 열기 → 헤더 검증 → 전체를 읽기 전용으로 매핑 */
+bool ShmRingFrameSource::attach()
+{
+    const int fd = shm_open(name_.toLocal8Bit().constData(), O_RDONLY, 0);
+    if (fd < 0)
+    {
+        qWarning() << "shm open fail:" << name_ << "(writer not running?)";
+        return false;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(shmring::Header))
+    {
+        ::close(fd);
+        return false;
+    }
+    void *base = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // 매핑은 fd와 무관하게 유지
+    if (base == MAP_FAILED)
+        return false;
+
+    auto *h = static_cast<shmring::Header *>(base);
+    const int type = int(h->cvType);
+    const bool valid = h->magic == shmring::kMagic && h->version == shmring::kVersion && (type == CV_8UC3 || type == CV_8UC4 || type == CV_8UC1) && h->slotCount > 0 && h->width > 0 && h->height > 0 &&
+                       h->stride >= h->width * CV_ELEM_SIZE(type) && h->slotBytes >= shmring::slotBytes(h->stride, h->height) &&
+                       shmring::totalBytes(h->slotCount, h->slotBytes) <= size_t(st.st_size);
+    if (!valid)
+    {
+        qWarning() << "shm ring header invalid:" << name_;
+        munmap(base, size_t(st.st_size));
+        return false;
+    }
+    close();
+    base_ = base;
+    mappedBytes_ = size_t(st.st_size);
+    dev_ = quint64(st.st_dev);
+    ino_ = quint64(st.st_ino);
+    header_ = h;
+    lastFrame_ = h->latest.load(std::memory_order_acquire); // 연결 전 프레임은 건너뜀
+    dropped_ = 0;
+    return true;
+}
+
+/* 생산자 재시작 감지: 이름이 없으면(생산자 종료) 기존 매핑 유지 */
+bool ShmRingFrameSource::writerReplaced() const
+{
+    const int fd = shm_open(name_.toLocal8Bit().constData(), O_RDONLY, 0);
+    if (fd < 0)
+        return false;
+    struct stat st{};
+    const bool replaced = fstat(fd, &st) == 0 && (quint64(st.st_dev) != dev_ || quint64(st.st_ino) != ino_);
+    ::close(fd);
+    return replaced;
+}
+
+cv::Size ShmRingFrameSource::frameSize() const { return header_ ? cv::Size(int(header_->width), int(header_->height)) : cv::Size(); }
+
+/* 최신 완료 슬롯을 슬롯 버퍼로 복사(BGR 이외 형식은 변환) 후 seqlock 재확인 */
+bool ShmRingFrameSource::read(CapturedFrame &slot)
+{
+    if (!header_)
+        return false;
+    pace();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    for (;;)
+    {
+        const quint64 n = header_->latest.load(std::memory_order_acquire);
+        if (n != 0 && n != lastFrame_)
+        {
+            shmring::SlotHeader *s = shmring::slotAt(base_, *header_, n);
+            // 짝수 2n이어야 프레임 n이 완성된 상태(홀수 = 쓰는 중, 더 큼 = 이미 덮어씀)
+            if (s->seq.load(std::memory_order_acquire) == 2 * n)
+            {
+                const int type = int(header_->cvType);
+                const cv::Mat view(int(header_->height), int(header_->width), type, shmring::pixels(s), header_->stride);
+                if (type == CV_8UC3)
+                    view.copyTo(slot.bgr);
+                else if (type == CV_8UC4)
+                    cv::cvtColor(view, slot.bgr, cv::COLOR_BGRA2BGR);
+                else
+                    cv::cvtColor(view, slot.bgr, cv::COLOR_GRAY2BGR);
+                // 복사 중에 생산자가 링을 돌아 이 슬롯을 다시 쓰기 시작했으면 버리고 다음 최신 프레임으로
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s->seq.load(std::memory_order_relaxed) == 2 * n)
+                {
+                    if (lastFrame_ != 0 && n > lastFrame_ + 1)
+                        dropped_ += n - lastFrame_ - 1;
+                    lastFrame_ = n;
+                    slot.jpeg.release();
+                    slot.decodeMs = 0.f;
+                    return true;
+                }
+                continue;
+            }
+        }
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            if (writerReplaced() && attach())
+                qInfo() << "shm ring reattached:" << name_;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
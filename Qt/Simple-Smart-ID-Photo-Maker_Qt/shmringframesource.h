@@ -0,0 +1,40 @@
+#ifndef SHMRINGFRAMESOURCE_H
+#define SHMRINGFRAMESOURCE_H
+
+#include "framesource.h"
+#include "shmframering.h"
+
+/*
+ * 외부 캡처 프로세스가 쓰는 POSIX 공유 메모리 링(shmframering.h)에서 최신 프레임을 읽음
+ * - 프레임은 슬롯 버퍼로 복사(BGR 이외 형식은 변환)하고 seqlock을 다시 확인해 찢어진 프레임은 버림
+ * - 새 프레임이 없으면 짧게 대기 후 false(캡처 루프가 재시도). 그때 생산자가 재시작해 링을 새로 만들었으면 다시 매핑
+ */
+class ShmRingFrameSource : public FrameSource
+{
+  public:
+    explicit ShmRingFrameSource(const QString &name); // 예: "/idphoto_frames"
+    ~ShmRingFrameSource() override;
+
+    bool open() override;
+    bool isOpened() const override { return header_ != nullptr; }
+    bool read(CapturedFrame &slot) override;
+    cv::Size frameSize() const override;
+    QString describe() const override { return QString("shm:%1").arg(name_); }
+
+    quint64 droppedFrames() const { return dropped_; } // 생산자보다 늦어 건너뛴 프레임 수
+
+  private:
+    void close();
+    bool attach();               // 매핑 성공 시 기존 매핑과 교체(실패하면 기존 유지)
+    bool writerReplaced() const; // 이름이 가리키는 객체가 매핑한 것과 다른지
+
+    QString name_;
+    void *base_ = nullptr;
+    size_t mappedBytes_ = 0;
+    quint64 dev_ = 0, ino_ = 0; // 매핑한 공유 메모리 객체
+    shmring::Header *header_ = nullptr;
+    quint64 lastFrame_ = 0;
+    quint64 dropped_ = 0;
+};
+
+#endif // SHMRINGFRAMESOURCE_H
@@ -0,0 +1,26 @@
+#include "startuptrace.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QSet>
+
+namespace
+{
+QElapsedTimer clock_;
+QMutex mutex_;
+QSet<QByteArray> marked_;
+} // namespace
+
+void StartupTrace::begin() { clock_.start(); }
+
+qint64 StartupTrace::elapsedMs() { return clock_.isValid() ? clock_.elapsed() : -1; }
+
+/* 단계 도달 시각을 한 번만 기록 */
+void StartupTrace::mark(const char *stage)
+{
+    QMutexLocker lock(&mutex_);
+    if (!clock_.isValid() || marked_.contains(stage))
+        return;
+    marked_.insert(stage);
+    qInfo().noquote() << QString("[startup] %1: %2 ms").arg(stage).arg(clock_.elapsed());
+}
@@ -0,0 +1,19 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QtGlobal>
+
+/*
+ * 시작 시간 계측(프로세스 시작 기준 ms)
+ * - main() 첫 줄에서 begin(), 각 단계에서 mark("...")
+ * - 같은 이름은 처음 한 번만 기록 → "[startup] window shown: 85 ms" 형태로 출력
+ * - 어느 스레드에서나 호출 가능
+ */
+namespace StartupTrace
+{
+void begin();
+qint64 elapsedMs();
+void mark(const char *stage);
+} // namespace StartupTrace
+
+#endif // STARTUPTRACE_H
@@ -1,33 +1,32 @@
 #include "suitcomposer.h"
+#include "alphaover.h"
+#include "facetracker.h"
+#include "guidedfilter.h"
+#include "modelregistry.h"
+#include <QDebug>
 #include <QFileInfo>
 #include <QImage>
+#include <opencv2/core/hal/intrin.hpp>
 using namespace cv;
 
-/* 생성자: 얼굴 검출용 하르 캐스케이드 로드 */
-SuitComposer::SuitComposer(QObject *parent) : QObject{parent}
-{
-    hasCascade_ = faceDet_.load("/usr/share/opencv4/haarcascades/haarcascade_frontalface_default.xml") || faceDet_.load("/usr/share/opencv/haarcascades/haarcascade_frontalface_default.xml") || faceDet_.load("haarcascade_frontalface_default.xml");
-    if (!hasCascade_)
-        emit warn("face cascade not found");
-}
+/* 생성자: 리소스는 loadSuit/loadGuide/loadFaceCascade 또는 loadAssets/setAssets로 로드 */
+SuitComposer::SuitComposer(QObject *parent) : QObject{parent} {}
 
 /* 출력 캔버스 크기와 목 절단선 설정 */
 void SuitComposer::setCanvas(int w, int h, int neckY)
 {
+    QMutexLocker lock(&settingsMutex_);
     W_ = w;
     H_ = h;
     neckY_ = neckY;
 }
 
-/* 수트 PNG 로드(RGBA 보장, 크기 보정) */
-bool SuitComposer::loadSuit(const QString &path)
+/* PNG를 RGBA(8UC4)로 읽어 캔버스 크기로 보정 */
+Mat SuitComposer::readRGBA(const QString &path, Size canvas, Mat *original)
 {
     Mat m = imread(path.toStdString(), IMREAD_UNCHANGED); // 8UC4 선호
     if (m.empty())
-    {
-        emit error(QString("suit load fail: %1").arg(path));
-        return false;
-    }
+        return m;
     if (m.channels() == 3)
     { // 알파 없으면 추가(255)
         std::vector<Mat> ch;
@@ -35,9 +34,41 @@ bool SuitComposer::loadSuit(const QString &path)
         ch.push_back(Mat(m.size(), CV_8U, Scalar(255)));
         merge(ch, m);
     }
-    if (m.cols != W_ || m.rows != H_)
-        resize(m, m, Size(W_, H_)); // 캔버스 크기 맞춤
-    suitRGBA_ = std::move(m);
+    if (original)
+        *original = m;
+    if (m.size() != canvas)
+    {
+        Mat fitted;
+        resize(m, fitted, canvas); // 캔버스 크기 맞춤
+        return fitted;
+    }
+    return m;
+}
+
+/* 알파가 전부 0이 아닌지 */
+bool SuitComposer::hasVisibleAlpha(const Mat &rgba)
+{
+    Mat a;
+    extractChannel(rgba, a, 3);
+    return countNonZero(a) > 0;
+}
+
+/* 수트 PNG 로드(RGBA 보장, 크기 보정) */
+bool SuitComposer::loadSuit(const QString &path)
+{
+    Mat full;
+    Mat m = readRGBA(path, Size(W_, H_), &full);
+    if (m.empty())
+    {
+        emit error(QString("suit load fail: %1").arg(path));
+        return false;
+    }
+    {
+        QMutexLocker lock(&settingsMutex_);
+        suitRGBA_ = std::move(m);
+        suitFullRGBA_ = std::move(full);
+    }
+    invalidateGuideCache();
     emit info(QString("suit: %1").arg(QFileInfo(path).fileName()));
     return true;
 }
@@ -45,204 +76,907 @@ bool SuitComposer::loadSuit(const QString &path)
 /* 가이드 PNG 로드(옵션). 알파 전부 0이면 비활성화 */
 bool SuitComposer::loadGuide(const QString &path)
 {
-    Mat g = imread(path.toStdString(), IMREAD_UNCHANGED);
+    Mat g = readRGBA(path, Size(W_, H_));
     guideOK_ = false;
     if (g.empty())
     {
         emit warn(QString("guide load fail: %1").arg(path));
         return false;
     }
-    if (g.channels() == 3)
-    { // 알파 강제 추가
-        std::vector<Mat> ch;
-        split(g, ch);
-        ch.push_back(Mat(g.size(), CV_8U, Scalar(255)));
-        merge(ch, g);
-    }
-    if (g.cols != W_ || g.rows != H_)
-        resize(g, g, Size(W_, H_));
-    std::vector<Mat> ch;
-    split(g, ch);
-    if (countNonZero(ch[3]) == 0)
+    if (!hasVisibleAlpha(g))
     { // 알파가 전부 0 → 사용 안 함
         emit warn("guide alpha all zero. overlay off");
         return false;
     }
     guideRGBA_ = std::move(g);
     guideOK_ = true;
+    invalidateGuideCache();
     emit info(QString("guide: %1").arg(QFileInfo(path).fileName()));
     return true;
 }
 
+/* 얼굴 검출기 로드(모델 저장소의 독립 인스턴스, 로드 완료까지 대기) */
+bool SuitComposer::loadFaceCascade()
+{
+    const Ptr<CascadeClassifier> det = ModelRegistry::instance().createFaceCascade();
+    std::shared_ptr<CascadeClassifier> faceDet;
+    if (!det.empty())
+        faceDet = std::make_shared<CascadeClassifier>(*det);
+    else
+        emit warn("face cascade not found");
+    QMutexLocker lock(&settingsMutex_);
+    faceDet_ = std::move(faceDet);
+    return faceDet_ != nullptr;
+}
+
+/* 수트/가이드/얼굴 검출기 일괄 로드(백그라운드 스레드용) */
+SuitAssets SuitComposer::loadAssets(const QString &suitPath, const QString &guidePath, Size canvas)
+{
+    SuitAssets a;
+    a.suitRGBA = readRGBA(suitPath, canvas, &a.suitFullRGBA);
+    if (a.suitRGBA.empty())
+        a.warnings << QString("suit load fail: %1").arg(suitPath);
+    if (!guidePath.isEmpty())
+    {
+        a.guideRGBA = readRGBA(guidePath, canvas);
+        if (a.guideRGBA.empty())
+            a.warnings << QString("guide load fail: %1").arg(guidePath);
+        else if (!hasVisibleAlpha(a.guideRGBA))
+        {
+            a.guideRGBA.release();
+            a.warnings << "guide alpha all zero. overlay off";
+        }
+    }
+    // 합성 스레드용은 독립 인스턴스, 프리뷰 추적(GUI 스레드)은 저장소의 공유 인스턴스
+    ModelRegistry &models = ModelRegistry::instance();
+    const Ptr<CascadeClassifier> det = models.createFaceCascade();
+    a.hasCascade = !det.empty();
+    if (a.hasCascade)
+    {
+        a.faceDet = *det;
+        a.trackerDet = *models.faceCascade().result();
+    }
+    else
+        a.warnings << "face cascade not found";
+    return a;
+}
+
+/* loadAssets 결과 적용(GUI 스레드) */
+bool SuitComposer::setAssets(SuitAssets assets)
+{
+    for (const QString &w : assets.warnings)
+        emit warn(w);
+    {
+        // 진행 중인 작업은 스냅샷의 수트/검출기를 계속 쓰고, 여기서는 멤버만 새 것으로 교체
+        QMutexLocker lock(&settingsMutex_);
+        if (!assets.suitRGBA.empty())
+        {
+            suitRGBA_ = std::move(assets.suitRGBA);
+            suitFullRGBA_ = std::move(assets.suitFullRGBA);
+        }
+        faceDet_ = assets.hasCascade ? std::make_shared<CascadeClassifier>(assets.faceDet) : nullptr;
+        if (!assets.cleanPlate.empty())
+            segmentMode_ = SegmentMode::CleanPlate;
+    }
+    guideOK_ = !assets.guideRGBA.empty();
+    guideRGBA_ = std::move(assets.guideRGBA);
+    invalidateGuideCache();
+    if (!assets.cleanPlate.empty())
+        setCleanPlate(assets.cleanPlate);
+    return isReady();
+}
+
+/* 프리뷰 추적 결과 보관(합성 스레드가 얼굴 검출 범위로 사용) */
+void SuitComposer::setFaceHint(const cv::Rect2f &normRect, float confidence)
+{
+    QMutexLocker lock(&liveMutex_);
+    faceHint_ = normRect;
+    faceHintConfidence_ = confidence;
+    faceHintTime_ = std::chrono::steady_clock::now();
+}
+
 /* 미러/가이드 표시/불투명도/배경색 설정 */
-void SuitComposer::setMirror(bool on) { mirror_ = on; }
+void SuitComposer::setMirror(bool on)
+{
+    QMutexLocker lock(&settingsMutex_);
+    mirror_ = on;
+}
 void SuitComposer::setGuideVisible(bool on) { showGuide_ = on; }
 void SuitComposer::setGuideOpacity(double a01) { guideOpacity_ = std::clamp(a01, 0.0, 1.0); }
-void SuitComposer::setBackgroundColor(const cv::Scalar &color) { backgroundColor_ = color; }
+void SuitComposer::setBackgroundColor(const cv::Scalar &color)
+{
+    QMutexLocker lock(&settingsMutex_);
+    backgroundColor_ = color;
+}
 
-/* 프리뷰용: 입력 BGR → 미러/리사이즈 → 가이드 오버레이 후 BGR 반환 */
-cv::Mat SuitComposer::makePreviewBGR(const cv::Mat &frameBGR) const
+/* 분할 방식/엔진/수렴 기준/출력 배율 설정(다음에 제출하는 작업부터 적용) */
+void SuitComposer::setSegmentMode(SegmentMode mode)
 {
-    Mat view;
-    if (mirror_)
-        flip(frameBGR, view, 1);
+    QMutexLocker lock(&settingsMutex_);
+    segmentMode_ = mode;
+}
+
+SuitComposer::SegmentMode SuitComposer::segmentMode() const
+{
+    QMutexLocker lock(&settingsMutex_);
+    return segmentMode_;
+}
+
+void SuitComposer::setSegmentEngine(SegmentEngine engine)
+{
+    QMutexLocker lock(&settingsMutex_);
+    segmentEngine_ = engine;
+}
+
+SuitComposer::SegmentEngine SuitComposer::segmentEngine() const
+{
+    QMutexLocker lock(&settingsMutex_);
+    return segmentEngine_;
+}
+
+void SuitComposer::setSegmentConvergence(double ratio)
+{
+    QMutexLocker lock(&settingsMutex_);
+    segmentConvergence_ = ratio;
+}
+
+void SuitComposer::setMaxOutputScale(double maxScale)
+{
+    QMutexLocker lock(&settingsMutex_);
+    maxOutputScale_ = std::max(1.0, maxScale);
+}
+
+/* 작업 제출 시점의 합성 설정 복사(Mat/검출기는 참조만 공유) */
+SuitComposer::Settings SuitComposer::settings() const
+{
+    QMutexLocker lock(&settingsMutex_);
+    Settings s;
+    s.W = W_;
+    s.H = H_;
+    s.neckY = neckY_;
+    s.mirror = mirror_;
+    s.backgroundColor = backgroundColor_;
+    s.mode = segmentMode_;
+    s.engine = segmentEngine_;
+    s.convergence = segmentConvergence_;
+    s.maxOutputScale = maxOutputScale_;
+    s.suitRGBA = suitRGBA_;
+    s.suitFullRGBA = suitFullRGBA_;
+    s.faceDet = faceDet_;
+    return s;
+}
+
+void SuitComposer::setWarmStartEnabled(bool on)
+{
+    QMutexLocker lock(&warmMutex_);
+    warmStartEnabled_ = on;
+    if (!on)
+        warm_ = WarmStart();
+}
+
+void SuitComposer::resetWarmStart()
+{
+    {
+        QMutexLocker lock(&warmMutex_);
+        warm_ = WarmStart();
+    }
+    QMutexLocker lock(&liveMutex_);
+    liveLut_.reset();
+}
+
+SuitComposer::SegmentStats SuitComposer::lastSegmentStats() const
+{
+    QMutexLocker lock(&warmMutex_);
+    return lastStats_;
+}
+
+bool SuitComposer::hasLiveMatteModel() const
+{
+    QMutexLocker lock(&liveMutex_);
+    return liveLut_ != nullptr;
+}
+
+void SuitComposer::setCleanPlate(const cv::Mat &frameBGR)
+{
+    std::shared_ptr<const Mat> plate;
+    if (!frameBGR.empty())
+    {
+        CV_Assert(frameBGR.type() == CV_8UC3);
+        plate = std::make_shared<const Mat>(frameBGR.clone());
+    }
+    QMutexLocker lock(&liveMutex_);
+    cleanPlate_ = std::move(plate);
+}
+
+bool SuitComposer::hasCleanPlate() const
+{
+    QMutexLocker lock(&liveMutex_);
+    return cleanPlate_ != nullptr;
+}
+
+void SuitComposer::setCleanPlateThresholds(int lo, int hi)
+{
+    QMutexLocker lock(&liveMutex_);
+    plateLo_ = std::clamp(lo, 0, 239);
+    plateHi_ = std::clamp(hi, plateLo_ + 16, 255);
+}
+
+/* 실시간 매트 준비: 합성 없이 분할만 수행(색 모델 학습 → 표 생성) */
+bool SuitComposer::warmUpLiveMatte(const cv::Mat &frameBGR, const Settings &settings, const ComposeControl *ctl)
+{
+    if (frameBGR.empty())
+        return false;
+    FrameContext viewCtx(makeView(frameBGR, settings));
+    return !segmentView(viewCtx, settings, ctl, SegmentUse::LiveWarmUp).empty() && hasLiveMatteModel();
+}
+
+void SuitComposer::invalidateGuideCache()
+{
+    preview_.guideSize = Size();
+    preview_.guidePremul.release();
+    preview_.guideOutline.release();
+    preview_.suitSize = Size();
+    preview_.suitPremul.release();
+}
+
+/* 미러를 포함한 리샘플 맵(resize INTER_LINEAR와 같은 픽셀 중심 좌표계) */
+void SuitComposer::preparePreviewMaps(Size src, Size out) const
+{
+    if (preview_.src == src && preview_.out == out && preview_.mirror == mirror_ && !preview_.map1.empty())
+        return;
+    const float sx = float(src.width) / out.width, sy = float(src.height) / out.height;
+    Mat mx(out, CV_32F), my(out, CV_32F);
+    float *row = mx.ptr<float>(0);
+    for (int x = 0; x < out.width; ++x)
+    {
+        const float fx = (x + 0.5f) * sx - 0.5f;
+        row[x] = mirror_ ? float(src.width - 1) - fx : fx;
+    }
+    for (int y = 0; y < out.height; ++y)
+    {
+        if (y > 0)
+            mx.row(0).copyTo(mx.row(y));
+        my.row(y).setTo((y + 0.5f) * sy - 0.5f);
+    }
+    convertMaps(mx, my, preview_.map1, preview_.map2, CV_16SC2);
+    preview_.plate.release();
+    preview_.src = src;
+    preview_.out = out;
+    preview_.mirror = mirror_;
+}
+
+/* 프리뷰 크기의 프리멀티플라이 가이드(불투명도 포함)와 외곽선 마스크 준비 */
+void SuitComposer::prepareGuide(Size size) const
+{
+    if (preview_.guideSize == size && preview_.guideOpacity == guideOpacity_)
+        return;
+    Mat g;
+    if (guideRGBA_.size() == size)
+        g = guideRGBA_;
     else
-        view = frameBGR.clone();
-    resize(view, view, Size(W_, H_));
-    if (showGuide_ && guideOK_)
+        resize(guideRGBA_, g, size, 0, 0, INTER_AREA);
+
+    preview_.guidePremul.create(size, CV_8UC4);
+    for (int y = 0; y < size.height; ++y)
     {
-        Mat tmp = view.clone();
-        overlayRGBA(tmp, guideRGBA_, guideOpacity_); // BGR 위 RGBA 오버레이
-        return tmp;
+        const uchar *s = g.ptr<uchar>(y);
+        uchar *d = preview_.guidePremul.ptr<uchar>(y);
+        for (int x = 0; x < size.width; ++x, s += 4, d += 4)
+        {
+            const int a = cvRound(s[3] * guideOpacity_);
+            for (int c = 0; c < 3; ++c)
+                d[c] = saturate_cast<uchar>(cvRound(s[c] * a / 255.0));
+            d[3] = uchar(255 - a);
+        }
     }
-    return view;
+
+    Mat a;
+    extractChannel(g, a, 3);
+    threshold(a, a, 0, 255, THRESH_BINARY);
+    morphologyEx(a, preview_.guideOutline, MORPH_GRADIENT, getStructuringElement(MORPH_RECT, Size(3, 3)));
+    preview_.guideSize = size;
+    preview_.guideOpacity = guideOpacity_;
+}
+
+/* 실시간 매트용 프리멀티플라이 수트(불투명도 1, guidePremul과 같은 배치) */
+void SuitComposer::prepareSuit(Size size) const
+{
+    if (preview_.suitSize == size && !preview_.suitPremul.empty())
+        return;
+    Mat s;
+    if (suitRGBA_.size() == size)
+        s = suitRGBA_;
+    else
+        resize(suitRGBA_, s, size, 0, 0, INTER_AREA);
+    preview_.suitPremul.create(size, CV_8UC4);
+    for (int y = 0; y < size.height; ++y)
+    {
+        const uchar *p = s.ptr<uchar>(y);
+        uchar *d = preview_.suitPremul.ptr<uchar>(y);
+        for (int x = 0; x < size.width; ++x, p += 4, d += 4)
+        {
+            for (int c = 0; c < 3; ++c)
+                d[c] = saturate_cast<uchar>(cvRound(p[c] * p[3] / 255.0));
+            d[3] = uchar(255 - p[3]);
+        }
+    }
+    preview_.suitSize = size;
+}
+
+/* 실시간 매트 원시 알파 한 행: 색 표 조회(스칼라, 32KB 표는 L1에 상주) */
+static void lutAlphaRow(const uchar *lut, const uchar *bgr, uchar *alpha, int n)
+{
+    for (int x = 0; x < n; ++x, bgr += 3)
+        alpha[x] = lut[((bgr[0] >> 3) << 10) | ((bgr[1] >> 3) << 5) | (bgr[2] >> 3)];
 }
 
-/* 가장 큰 얼굴 검출(없으면 빈 Rect) */
-cv::Rect SuitComposer::detectLargestFace(const cv::Mat &viewBGR, cv::CascadeClassifier *det)
+/* 클린 플레이트 색 차 한 행: d = max(|ΔB|, |ΔG|, |ΔR|) */
+static void plateDiffRow(const uchar *bgr, const uchar *plate, uchar *d, int n)
+{
+    int x = 0;
+#if CV_SIMD128
+    for (; x <= n - 16; x += 16)
+    {
+        v_uint8x16 a[3], b[3];
+        v_load_deinterleave(bgr + 3 * x, a[0], a[1], a[2]);
+        v_load_deinterleave(plate + 3 * x, b[0], b[1], b[2]);
+        v_store(d + x, v_max(v_absdiff(a[0], b[0]), v_max(v_absdiff(a[1], b[1]), v_absdiff(a[2], b[2]))));
+    }
+#endif
+    for (; x < n; ++x)
+    {
+        const uchar *a = bgr + 3 * x, *b = plate + 3 * x;
+        d[x] = uchar(std::max({std::abs(a[0] - b[0]), std::abs(a[1] - b[1]), std::abs(a[2] - b[2])}));
+    }
+}
+
+/* 색 차 → 알파 램프(제자리): d <= lo → 0, d >= hi → 255, 사이는 선형(1/16 고정소수점). hi - lo >= 16 */
+static void plateRampRow(uchar *d, int n, int lo, int hi)
+{
+    const int k = cvRound(255.0 * 16 / (hi - lo)); // <= 255 → (d-lo)*k는 16비트 안
+    int x = 0;
+#if CV_SIMD128
+    const v_uint8x16 vlo = v_setall_u8(uchar(lo));
+    const v_uint16x8 vk = v_setall_u16(ushort(k));
+    for (; x <= n - 16; x += 16)
+    {
+        v_uint16x8 l, h;
+        v_expand(v_load(d + x) - vlo, l, h); // 포화 뺄셈
+        v_store(d + x, v_pack(v_mul_wrap(l, vk) >> 4, v_mul_wrap(h, vk) >> 4));
+    }
+#endif
+    for (; x < n; ++x)
+        d[x] = saturate_cast<uchar>((std::max(0, d[x] - lo) * k) >> 4);
+}
+
+/*
+ * 실시간 매트 한 행(제자리): 원시 알파를 앞 프레임 알파와 평균 → 배경색 위에 합성
+ *   a = avg(raw, prev) (prime이면 평균 없이), C = round((C*a + bg*(255-a))/255)
+ * 평활과 합성은 16픽셀 단위 SIMD
+ */
+static void liveMatteRow(const uchar *raw, uchar *bgr, uchar *prev, const uchar bg[3], int n, bool prime)
+{
+    int x = 0;
+#if CV_SIMD128
+    const v_uint16x8 v128 = v_setall_u16(128), v255 = v_setall_u16(255);
+    auto div255 = [&](const v_uint16x8 &v) {
+        const v_uint16x8 t = v + v128;
+        return (t + (t >> 8)) >> 8;
+    };
+    v_uint16x8 bgv[3];
+    for (int c = 0; c < 3; ++c)
+        bgv[c] = v_setall_u16(bg[c]);
+    for (; x <= n - 16; x += 16)
+    {
+        v_uint8x16 a = v_load(raw + x);
+        if (!prime)
+            a = v_avg(a, v_load(prev + x));
+        v_store(prev + x, a);
+
+        v_uint8x16 b[3];
+        v_load_deinterleave(bgr + 3 * x, b[0], b[1], b[2]);
+        v_uint16x8 al, ah;
+        v_expand(a, al, ah);
+        const v_uint16x8 il = v255 - al, ih = v255 - ah;
+        for (int c = 0; c < 3; ++c)
+        {
+            v_uint16x8 bl, bh;
+            v_expand(b[c], bl, bh);
+            b[c] = v_pack(div255(v_mul_wrap(bl, al) + v_mul_wrap(bgv[c], il)), div255(v_mul_wrap(bh, ah) + v_mul_wrap(bgv[c], ih)));
+        }
+        v_store_interleave(bgr + 3 * x, b[0], b[1], b[2]);
+    }
+#endif
+    for (; x < n; ++x)
+    {
+        uchar *p = bgr + 3 * x;
+        int a = raw[x];
+        if (!prime)
+            a = (a + prev[x] + 1) >> 1;
+        prev[x] = uchar(a);
+        for (int c = 0; c < 3; ++c)
+        {
+            const int t = p[c] * a + bg[c] * (255 - a) + 128;
+            p[c] = uchar((t + (t >> 8)) >> 8);
+        }
+    }
+}
+
+/* 프리멀티플라이 가이드 합성 한 행(제자리): B = P + round(B*(255-a)/255) */
+static void blendPremulRow(const uchar *guide, uchar *bgr, int n)
+{
+    int x = 0;
+#if CV_SIMD128
+    const v_uint16x8 v128 = v_setall_u16(128);
+    auto div255 = [&](const v_uint16x8 &v) {
+        const v_uint16x8 t = v + v128; // v <= 65025 → 정확한 반올림 나눗셈
+        return (t + (t >> 8)) >> 8;
+    };
+    for (; x <= n - 16; x += 16)
+    {
+        v_uint8x16 p[4], b[3];
+        v_load_deinterleave(guide + 4 * x, p[0], p[1], p[2], p[3]);
+        v_load_deinterleave(bgr + 3 * x, b[0], b[1], b[2]);
+        v_uint16x8 il, ih;
+        v_expand(p[3], il, ih);
+        for (int c = 0; c < 3; ++c)
+        {
+            v_uint16x8 bl, bh, pl, ph;
+            v_expand(b[c], bl, bh);
+            v_expand(p[c], pl, ph);
+            b[c] = v_pack(pl + div255(v_mul_wrap(bl, il)), ph + div255(v_mul_wrap(bh, ih)));
+        }
+        v_store_interleave(bgr + 3 * x, b[0], b[1], b[2]);
+    }
+#endif
+    for (; x < n; ++x)
+    {
+        const uchar *p = guide + 4 * x;
+        uchar *b = bgr + 3 * x;
+        for (int c = 0; c < 3; ++c)
+        {
+            const int t = b[c] * p[3] + 128;
+            b[c] = saturate_cast<uchar>(p[c] + ((t + (t >> 8)) >> 8));
+        }
+    }
+}
+
+/* 프리뷰: 행 묶음마다 미러+리사이즈(remap) 후 같은 행에 가이드 합성(캐시에 남아 있을 때 처리) */
+void SuitComposer::makePreview(const cv::Mat &frameBGR, cv::Mat &out, double scale, GuideStyle style) const
+{
+    CV_Assert(frameBGR.type() == CV_8UC3);
+    const Size outSize(std::max(1, int(std::lround(W_ * scale))), std::max(1, int(std::lround(H_ * scale))));
+    preparePreviewMaps(frameBGR.size(), outSize);
+    out.create(outSize, CV_8UC3);
+
+    // 실시간 매트: 클린 플레이트 모드면 플레이트 색 차, 아니면 색 모델 표. 있으면 가이드 대신 배경색 ⊕ 얼굴 ⊕ 수트
+    std::shared_ptr<const Mat> lut, plate;
+    int plateLo = 0, plateHi = 0;
+    if (liveMatte_ && !suitRGBA_.empty())
+    {
+        QMutexLocker lock(&liveMutex_);
+        if (segmentMode_ == SegmentMode::CleanPlate && cleanPlate_)
+        {
+            plate = cleanPlate_;
+            plateLo = plateLo_;
+            plateHi = plateHi_;
+        }
+        else
+            lut = liveLut_;
+    }
+    const std::shared_ptr<const Mat> &matteSource = plate ? plate : lut;
+    const bool live = matteSource != nullptr;
+    bool prime = false;
+    if (live)
+    {
+        prepareSuit(outSize);
+        if (preview_.liveAlpha.size() != outSize || preview_.liveLut != matteSource)
+        {
+            preview_.liveAlpha.create(outSize, CV_8U);
+            preview_.liveLut = matteSource;
+            prime = true;
+        }
+    }
+    else
+        preview_.liveLut.reset();
+    if (plate && (preview_.plate.empty() || preview_.plateSource != plate))
+    {
+        // 플레이트를 현재 프레임 크기로 맞춘 뒤 프리뷰와 같은 맵으로 리샘플(미러 포함)
+        Mat src = *plate;
+        if (src.size() != frameBGR.size())
+            resize(src, src, frameBGR.size(), 0, 0, INTER_AREA);
+        remap(src, preview_.plate, preview_.map1, preview_.map2, INTER_LINEAR, BORDER_REPLICATE);
+        preview_.plateSource = plate;
+    }
+    const int cutRow = neckY_ >= 0 ? int(std::lround(neckY_ * scale)) : outSize.height;
+    const uchar bg[3] = {saturate_cast<uchar>(backgroundColor_[0]), saturate_cast<uchar>(backgroundColor_[1]), saturate_cast<uchar>(backgroundColor_[2])};
+
+    const bool guide = !live && showGuide_ && guideOK_;
+    if (guide)
+        prepareGuide(outSize);
+
+    const Scalar outlineColor = Scalar::all(255 * guideOpacity_);
+    parallel_for_(
+        Range(0, outSize.height),
+        [&](const Range &r) {
+            const Rect rows(0, r.start, outSize.width, r.end - r.start);
+            Mat dst = out(rows);
+            remap(frameBGR, dst, preview_.map1(rows), preview_.map2(rows), INTER_LINEAR, BORDER_REPLICATE);
+            if (live)
+            {
+                std::vector<uchar> raw(dst.cols);
+                for (int y = 0; y < dst.rows; ++y)
+                {
+                    const int oy = r.start + y;
+                    uchar *row = dst.ptr<uchar>(y);
+                    if (oy >= cutRow)
+                        std::fill(raw.begin(), raw.end(), uchar(0));
+                    else if (plate)
+                    {
+                        plateDiffRow(row, preview_.plate.ptr<uchar>(oy), raw.data(), dst.cols);
+                        plateRampRow(raw.data(), dst.cols, plateLo, plateHi);
+                    }
+                    else
+                        lutAlphaRow(lut->ptr<uchar>(), row, raw.data(), dst.cols);
+                    liveMatteRow(raw.data(), row, preview_.liveAlpha.ptr<uchar>(oy), bg, dst.cols, prime);
+                    blendPremulRow(preview_.suitPremul.ptr<uchar>(oy), row, dst.cols);
+                }
+                return;
+            }
+            if (!guide)
+                return;
+            if (style == GuideStyle::Outline)
+                dst.setTo(outlineColor, preview_.guideOutline(rows));
+            else
+                for (int y = 0; y < dst.rows; ++y)
+                    blendPremulRow(preview_.guidePremul.ptr<uchar>(r.start + y), dst.ptr<uchar>(y), dst.cols);
+        },
+        std::max(1, outSize.height / 16)); // 16행 정도씩
+}
+
+cv::Mat SuitComposer::makePreviewBGR(const cv::Mat &frameBGR, double scale, GuideStyle style) const
+{
+    Mat out;
+    makePreview(frameBGR, out, scale, style);
+    return out;
+}
+
+/* 가장 큰 얼굴 검출(없으면 빈 Rect). 평활화 회색조는 컨텍스트 것을 공유 */
+cv::Rect SuitComposer::detectLargestFace(FrameContext &view, cv::CascadeClassifier *det)
 {
     if (!det)
         return {};
     std::vector<cv::Rect> faces;
-    cv::Mat gray;
-    cv::cvtColor(viewBGR, gray, cv::COLOR_BGR2GRAY);
-    cv::equalizeHist(gray, gray);
-    det->detectMultiScale(gray, faces, 1.1, 3, 0, cv::Size(60, 60));
+    det->detectMultiScale(view.equalizedGray(), faces, 1.1, 3, 0, cv::Size(60, 60));
     if (faces.empty())
         return {};
     int idx = 0;
     for (int i = 1; i < (int)faces.size(); ++i)
         if (faces[i].area() > faces[idx].area())
             idx = i;
-    Rect r = faces[idx] & Rect(0, 0, viewBGR.cols, viewBGR.rows);
+    Rect r = faces[idx] & Rect(Point(), view.size());
     return r.area() > 0 ? r : Rect();
 }
 
-/* 합성 파이프라인: GrabCut 알파 → 목 절단 → 경계 정리 → 수트⊕얼굴 RGBA */
-cv::Mat SuitComposer::composeRGBA(const cv::Mat &frameBGR)
+/* 미러 + 캔버스 크기로 리사이즈 */
+cv::Mat SuitComposer::makeView(const cv::Mat &frameBGR, const Settings &s)
 {
-    CV_Assert(!suitRGBA_.empty());
     Mat view;
-    if (mirror_)
+    if (s.mirror)
         flip(frameBGR, view, 1);
     else
         view = frameBGR.clone();
-    resize(view, view, Size(W_, H_));
+    resize(view, view, Size(s.W, s.H));
+    return view;
+}
+
+/* 캔버스 크기 뷰의 얼굴 알파(0/255). 성공 시 실시간 표, 촬영이면 직전 모델 캐시/통계도 갱신 */
+cv::Mat SuitComposer::segmentView(FrameContext &viewCtx, const Settings &s, const ComposeControl *ctl, SegmentUse use)
+{
+    const bool capture = use == SegmentUse::Capture;
+    const Mat &view = viewCtx.bgr();
+    const SegmentMode mode = s.mode;
+    // 클린 플레이트 모드: 색 차로 바로 알파, 실패하면 아래 GrabCut으로
+    if (mode == SegmentMode::CleanPlate)
+    {
+        std::shared_ptr<const Mat> plate;
+        int lo, hi;
+        {
+            QMutexLocker lock(&liveMutex_);
+            plate = cleanPlate_;
+            lo = plateLo_;
+            hi = plateHi_;
+        }
+        if (plate)
+        {
+            const auto t0 = std::chrono::steady_clock::now();
+            Mat alpha;
+            if (makeAlphaByCleanPlate(view, makeView(*plate, s), lo, hi, alpha))
+            {
+                SegmentStats stats;
+                stats.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+                if (capture)
+                {
+                    QMutexLocker lock(&warmMutex_);
+                    lastStats_ = stats;
+                }
+                if (ctl)
+                    ctl->report(80);
+                return alpha;
+            }
+            qInfo("[segment] clean-plate rejected, falling back to GrabCut");
+        }
+    }
 
-    // 얼굴 영역 초기값
-    Rect face = hasCascade_ ? detectLargestFace(view, &faceDet_) : Rect();
+    // 얼굴 영역 초기값: 최근 추적 결과가 믿을 만하면 그 주변만 검출, 아니면(또는 못 찾으면) 전체 검출
+    constexpr float kMinHintConfidence = 0.5f;
+    constexpr auto kMaxHintAge = std::chrono::milliseconds(500);
+    Rect2f hint;
+    {
+        QMutexLocker lock(&liveMutex_);
+        if (faceHintConfidence_ >= kMinHintConfidence && std::chrono::steady_clock::now() - faceHintTime_ < kMaxHintAge)
+            hint = faceHint_;
+    }
+    Rect face;
+    if (s.faceDet && hint.area() > 0)
+    {
+        const float x = s.mirror ? 1.f - hint.x - hint.width : hint.x;
+        face = FaceTracker::detectNear(*s.faceDet, viewCtx, Rect2f(x * s.W, hint.y * s.H, hint.width * s.W, hint.height * s.H), 0.5, 0.35);
+    }
+    if (s.faceDet && face.area() == 0)
+        face = detectLargestFace(viewCtx, s.faceDet.get());
+    if (ctl)
+    {
+        ctl->report(10);
+        if (ctl->isCancelled())
+            return Mat();
+    }
     if (face.area() == 0)
     { // 미검출 시 중앙 박스
-        int fw = int(W_ * 0.45), fh = int(H_ * 0.5);
-        face = Rect((W_ - fw) / 2, (H_ - fh) / 2, fw, fh);
+        int fw = int(s.W * 0.45), fh = int(s.H * 0.5);
+        face = Rect((s.W - fw) / 2, (s.H - fh) / 2, fw, fh);
     }
 
     // GrabCut 기반 알파 생성
     Mat tri = buildTrimap(view.size(), face, true);
+    // 직전 촬영 모델 재사용 여부: 색 평균이 비슷하고 오래되지 않았을 때만(조명/사람이 바뀌면 처음부터)
+    constexpr double kMaxDrift = 18.0; // BGR 평균 거리
+    constexpr auto kMaxAge = std::chrono::minutes(10);
+    const Scalar fgMean = mean(view, tri == GC_FGD);
+    const Scalar bgMean = mean(view, (tri == GC_BGD) | (tri == GC_PR_BGD));
+    SegmentJob job;
+    job.engine = s.engine;
+    job.convergence = s.convergence;
+    job.ctl = ctl;
+    if (capture)
+    {
+        QMutexLocker lock(&warmMutex_);
+        if (warmStartEnabled_ && !warm_.models.empty() && std::chrono::steady_clock::now() - warm_.time < kMaxAge && norm(fgMean - warm_.fgMean) < kMaxDrift && norm(bgMean - warm_.bgMean) < kMaxDrift)
+            job.models = GrabCutModels{warm_.models.bg.clone(), warm_.models.fg.clone()};
+    }
+    job.stats.warm = !job.models.empty();
+    job.iters = job.stats.warm ? 2 : 6;
+
     Mat alpha;
-    makeAlphaByGrabCut(view, tri, alpha, 6);
+    bool segmented;
+    {
+        QMutexLocker lock(&segmenterMutex_);
+        job.segmenter = &segmenter_;
+        segmented = mode == SegmentMode::FullGrabCut ? makeAlphaByGrabCut(view, tri, alpha, job) : makeAlphaByRoiGrabCut(view, tri, s.neckY, alpha, job);
+    }
+    if (!segmented)
+        return Mat();
+    if (capture)
+    {
+        QMutexLocker lock(&warmMutex_);
+        if (warmStartEnabled_ && !job.models.empty())
+            warm_ = WarmStart{job.models, fgMean, bgMean, std::chrono::steady_clock::now()};
+        lastStats_ = job.stats;
+    }
+
+    // 실시간 프리뷰용 표 갱신(수 ms, GUI 스레드는 이전 표를 계속 사용)
+    if (!job.models.empty())
+    {
+        auto lut = std::make_shared<const Mat>(GraphCutSegmenter::bakeForegroundLut(job.models.bg, job.models.fg, 5));
+        QMutexLocker lock(&liveMutex_);
+        liveLut_ = std::move(lut);
+    }
+    return alpha;
+}
 
-    // 목선 이하 제거
-    if (neckY_ >= 0 && neckY_ < alpha.rows)
-        alpha.rowRange(neckY_, alpha.rows).setTo(0);
+/* 캔버스 종횡비를 유지하며 프레임 해상도와 수트 원본 해상도가 허용하는 만큼(최대 maxOutputScale) 키운 출력 크기 */
+cv::Size SuitComposer::outputSizeFor(const Settings &s, cv::Size frameSize)
+{
+    const double fit = std::min(double(frameSize.width) / s.W, double(frameSize.height) / s.H);
+    // 수트는 원본보다 키우지 않음(확대하면 흐린 수트에 선명한 얼굴만 남음)
+    const Mat &suit = s.suitFullRGBA.empty() ? s.suitRGBA : s.suitFullRGBA;
+    const double suitFit = suit.empty() ? 1.0 : std::min(double(suit.cols) / s.W, double(suit.rows) / s.H);
+    const double k = std::clamp(fit, 1.0, std::max(1.0, std::min(s.maxOutputScale, suitFit)));
+    return Size(int(std::lround(s.W * k)), int(std::lround(s.H * k)));
+}
 
-    // 경계 정리: 이진화 → CLOSE → ERODE
-    threshold(alpha, alpha, 127, 255, THRESH_BINARY);
-    Mat k3 = getStructuringElement(MORPH_ELLIPSE, Size(3, 3));
-    morphologyEx(alpha, alpha, MORPH_CLOSE, k3, Point(-1, -1), 1);
-    erode(alpha, alpha, k3, Point(-1, -1), 1);
+cv::Size SuitComposer::outputSizeFor(cv::Size frameSize) const { return outputSizeFor(settings(), frameSize); }
+
+/*
+ * 합성 파이프라인: 캔버스에서 분할 → 출력 해상도 가이드 필터(정제 + 업샘플) → 목 절단 → 수트⊕얼굴 RGBA
+ * 출력 크기가 캔버스보다 크면 원본 프레임을 출력 크기로 줄인 영상이 가이드이자 얼굴 색
+ */
+cv::Mat SuitComposer::composeRGBA(const cv::Mat &frameBGR, const Settings &s, const ComposeControl *ctl)
+{
+    CV_Assert(!s.suitRGBA.empty());
+    FrameContext viewCtx(makeView(frameBGR, s));
+    const Mat &view = viewCtx.bgr();
+    Mat alpha = segmentView(viewCtx, s, ctl);
+    if (alpha.empty())
+        return Mat();
+
+    const Size outSize = outputSizeFor(s, frameBGR.size());
+    const double scale = double(outSize.height) / s.H;
+    Mat big;
+    if (outSize == view.size())
+        big = view;
+    else
+    {
+        if (s.mirror)
+            flip(frameBGR, big, 1);
+        else
+            big = frameBGR;
+        resize(big, big, outSize, 0, 0, INTER_AREA);
+    }
+
+    // 경계 정리: 한 픽셀 초크 후 프레임 밝기를 가이드로 한 가이드 필터 → 머리카락 등 경계가 부드러운 8비트 알파
+    // (전경 근처만, 계수는 캔버스 1/2 해상도에서 구해 출력 해상도 가이드로 업샘플) 희미한 잔여(8 이하)는 0으로
+    constexpr int kRefineRadius = 4; // 캔버스 기준
+    constexpr double kRefineEps = 1e-3;
+    alpha = GuidedFilter::refineMatte(big.data == view.data ? viewCtx.gray() : big, alpha, kRefineRadius, kRefineEps);
+    threshold(alpha, alpha, 8, 0, THRESH_TOZERO);
+
+    // 목선 이하 제거(필터가 번진 부분까지)
+    const int neckY = s.neckY >= 0 ? int(std::lround(s.neckY * scale)) : -1;
+    if (neckY >= 0 && neckY < alpha.rows)
+        alpha.rowRange(neckY, alpha.rows).setTo(0);
 
     // 얼굴 RGBA 구성
     std::vector<Mat> bgr;
-    split(view, bgr);
+    split(big, bgr);
     Mat faceRGBA;
     merge(std::vector<Mat>{bgr[0], bgr[1], bgr[2], alpha}, faceRGBA);
 
-    // 수트 ⊕ 얼굴 합성(비프리멀티플라이)
+    // 수트 ⊕ 얼굴 합성(비프리멀티플라이). 고해상도 수트는 이 작업 지역에서 출력 크기로 줄임
+    Mat suit = s.suitRGBA;
+    if (outSize != suit.size())
+        resize(s.suitFullRGBA.empty() ? s.suitRGBA : s.suitFullRGBA, suit, outSize, 0, 0, INTER_AREA);
     Mat out;
-    alphaOverRGBA(suitRGBA_, faceRGBA, out);
+    alphaover::over(suit, faceRGBA, out);
+    if (ctl)
+        ctl->report(90);
     return out; // 8UC4
 }
 
 /* 배경색이 적용된 BGR 이미지 반환 (투명 배경 대신) */
-cv::Mat SuitComposer::composeBGR(const cv::Mat &frameBGR)
+cv::Mat SuitComposer::composeBGR(const cv::Mat &frameBGR, const ComposeControl *ctl)
 {
-    // 먼저 RGBA 합성 이미지 생성
-    Mat composedRGBA = composeRGBA(frameBGR);
+    // 먼저 RGBA 합성 이미지 생성(배경색도 같은 스냅샷에서)
+    const Settings s = settings();
+    Mat composedRGBA = composeRGBA(frameBGR, s, ctl);
     if (composedRGBA.empty())
         return Mat();
 
-    // 배경색으로 채워진 BGR 이미지 생성
-    Mat backgroundBGR(composedRGBA.size(), CV_8UC3, backgroundColor_);
+    return flattenRGBA(composedRGBA, s.backgroundColor);
+}
 
-    // RGBA를 BGR 배경 위에 오버레이
-    Mat resultBGR = backgroundBGR.clone();
-    overlayRGBA(resultBGR, composedRGBA, 1.0);
+/* 단색 배경 평탄화 한 행: O = round((C*a + B*(255-a))/255) */
+static void flattenRow(const uchar *rgba, uchar *bgr, const int bg[3], int n)
+{
+    int x = 0;
+#if CV_SIMD128
+    const v_uint16x8 v128 = v_setall_u16(128);
+    auto div255 = [&](const v_uint16x8 &v) {
+        const v_uint16x8 t = v + v128; // v <= 65025 → 정확한 반올림 나눗셈
+        return (t + (t >> 8)) >> 8;
+    };
+    const v_uint8x16 v255 = v_setall_u8(255);
+    for (; x <= n - 16; x += 16)
+    {
+        v_uint8x16 p[4], o[3];
+        v_load_deinterleave(rgba + 4 * x, p[0], p[1], p[2], p[3]);
+        v_uint16x8 al, ah, il, ih;
+        v_expand(p[3], al, ah);
+        v_expand(v255 - p[3], il, ih);
+        for (int c = 0; c < 3; ++c)
+        {
+            const v_uint16x8 b = v_setall_u16(ushort(bg[c]));
+            v_uint16x8 cl, ch;
+            v_expand(p[c], cl, ch);
+            o[c] = v_pack(div255(v_mul_wrap(cl, al) + v_mul_wrap(b, il)), div255(v_mul_wrap(ch, ah) + v_mul_wrap(b, ih)));
+        }
+        v_store_interleave(bgr + 3 * x, o[0], o[1], o[2]);
+    }
+#endif
+    for (; x < n; ++x)
+    {
+        const uchar *p = rgba + 4 * x;
+        uchar *o = bgr + 3 * x;
+        const int a = p[3];
+        for (int c = 0; c < 3; ++c)
+        {
+            const int t = p[c] * a + bg[c] * (255 - a) + 128;
+            o[c] = uchar((t + (t >> 8)) >> 8);
+        }
+    }
+}
 
+/* RGBA를 단색 배경 위에 오버레이한 BGR 반환 */
+cv::Mat SuitComposer::flattenRGBA(const cv::Mat &rgba, const cv::Scalar &bgColor)
+{
+    CV_Assert(rgba.type() == CV_8UC4);
+    Mat resultBGR(rgba.size(), CV_8UC3);
+    const int bg[3] = {saturate_cast<uchar>(bgColor[0]), saturate_cast<uchar>(bgColor[1]), saturate_cast<uchar>(bgColor[2])};
+    parallel_for_(Range(0, rgba.rows), [&](const Range &r) {
+        for (int y = r.start; y < r.end; ++y)
+            flattenRow(rgba.ptr<uchar>(y), resultBGR.ptr<uchar>(y), bg, rgba.cols);
+    });
     return resultBGR;
 }
 
-/* 비프리멀티플라이 RGBA 오버 연산: out = fg ⊕ bg */
-void SuitComposer::alphaOverRGBA(const Mat &fgRGBA, const Mat &bgRGBA, Mat &outRGBA)
-{
-    CV_Assert(fgRGBA.type() == CV_8UC4 && bgRGBA.type() == CV_8UC4 && fgRGBA.size() == bgRGBA.size());
-    std::vector<Mat> fgc, bgc;
-    split(fgRGBA, fgc);
-    split(bgRGBA, bgc);
-    Mat af32, ab32;
-    fgc[3].convertTo(af32, CV_32F, 1.0 / 255.0);
-    bgc[3].convertTo(ab32, CV_32F, 1.0 / 255.0);
-    Mat outA32 = af32 + ab32.mul(1.0f - af32); // Aout
-
-    std::vector<Mat> out(4);
-    for (int c = 0; c < 3; c++)
-    {
-        Mat F, B, Fo;
-        fgc[c].convertTo(F, CV_32F);
-        bgc[c].convertTo(B, CV_32F);
-        Fo = F.mul(af32) + B.mul(ab32.mul(1.0f - af32)); // 분자
-        Mat denom;
-        max(outA32, 1e-6, denom); // 0 나눗셈 방지
-        Fo = Fo.mul(1.0f / denom);
-        Fo.convertTo(out[c], CV_8U);
-    }
-    outA32.convertTo(out[3], CV_8U, 255.0);
-    merge(out, outRGBA);
-}
-
-/* BGR 배경 위 RGBA를 opacity로 오버레이(프리뷰용) */
-void SuitComposer::overlayRGBA(Mat &bgr, const Mat &rgba, double opacity)
-{
-    CV_Assert(bgr.type() == CV_8UC3 && rgba.type() == CV_8UC4 && bgr.size() == rgba.size());
-    opacity = std::clamp(opacity, 0.0, 1.0);
-    std::vector<Mat> ch;
-    split(rgba, ch);
-    Mat a32;
-    ch[3].convertTo(a32, CV_32F, 1.0);
-    a32 *= opacity;
-    ch[3] = Mat();
-    a32.convertTo(ch[3], CV_8U);
-    Mat tmp;
-    merge(ch, tmp);
-
-    // 알파 혼합 O = F*a + B*(1-a)
-    std::vector<Mat> t;
-    split(tmp, t);
-    Mat a;
-    t[3].convertTo(a, CV_32F, 1.0f / 255.0f);
-    Mat ia;
-    subtract(1.0, a, ia);
-    std::vector<Mat> bb;
-    split(bgr, bb);
-    for (int c = 0; c < 3; c++)
+/* 배경색 교체 한 행: 채널별 차이 d를 배경 비율(255-a)만큼 더하거나 뺌(포화) */
+static void rebaseRow(const uchar *src, const uchar *alpha, uchar *dst, const int delta[3], int n)
+{
+    int x = 0;
+#if CV_SIMD128
+    const v_uint16x8 v128 = v_setall_u16(128);
+    auto div255 = [&](const v_uint16x8 &v) {
+        const v_uint16x8 t = v + v128;
+        return (t + (t >> 8)) >> 8;
+    };
+    const v_uint8x16 v255 = v_setall_u8(255);
+    for (; x <= n - 16; x += 16)
     {
-        Mat F, B, O;
-        t[c].convertTo(F, CV_32F);
-        bb[c].convertTo(B, CV_32F);
-        O = F.mul(a) + B.mul(ia);
-        O.convertTo(bb[c], CV_8U);
+        v_uint8x16 b[3];
+        v_load_deinterleave(src + 3 * x, b[0], b[1], b[2]);
+        v_uint16x8 il, ih;
+        v_expand(v255 - v_load(alpha + x), il, ih);
+        for (int c = 0; c < 3; ++c)
+        {
+            if (delta[c] == 0)
+                continue;
+            const v_uint16x8 d = v_setall_u16(ushort(std::abs(delta[c])));
+            const v_uint8x16 m = v_pack(div255(v_mul_wrap(il, d)), div255(v_mul_wrap(ih, d)));
+            b[c] = delta[c] > 0 ? b[c] + m : b[c] - m; // 8비트 +/-는 포화 연산
+        }
+        v_store_interleave(dst + 3 * x, b[0], b[1], b[2]);
     }
-    merge(bb, bgr);
+#endif
+    for (; x < n; ++x)
+    {
+        const int ia = 255 - alpha[x];
+        for (int c = 0; c < 3; ++c)
+        {
+            const int t = std::abs(delta[c]) * ia + 128;
+            const int m = (t + (t >> 8)) >> 8;
+            dst[3 * x + c] = saturate_cast<uchar>(src[3 * x + c] + (delta[c] < 0 ? -m : m));
+        }
+    }
+}
+
+/* 평탄화된 합성 결과의 배경색 교체: 픽셀마다 (to - from)*(255-a)/255를 더함(배경 픽셀이 from이었던 곳만 정확히 to) */
+void SuitComposer::rebaseBackground(const Mat &bgr, const Mat &alpha, const Scalar &from, const Scalar &to, Mat &out)
+{
+    CV_Assert(bgr.type() == CV_8UC3 && alpha.type() == CV_8UC1 && bgr.size() == alpha.size());
+    const int delta[3] = {saturate_cast<uchar>(to[0]) - saturate_cast<uchar>(from[0]), saturate_cast<uchar>(to[1]) - saturate_cast<uchar>(from[1]),
+                          saturate_cast<uchar>(to[2]) - saturate_cast<uchar>(from[2])};
+    if (delta[0] == 0 && delta[1] == 0 && delta[2] == 0)
+    {
+        if (out.data != bgr.data)
+            bgr.copyTo(out);
+        return;
+    }
+    if (out.data != bgr.data)
+        out.create(bgr.size(), CV_8UC3);
+    parallel_for_(Range(0, bgr.rows), [&](const Range &r) {
+        for (int y = r.start; y < r.end; ++y)
+            rebaseRow(bgr.ptr<uchar>(y), alpha.ptr<uchar>(y), out.ptr<uchar>(y), delta, bgr.cols);
+    });
 }
 
 /* GrabCut 트라이맵 생성: 얼굴 타원 FGD, 목은 PR_FGD, 외곽은 BGD */
@@ -269,13 +1003,180 @@ cv::Mat SuitComposer::buildTrimap(cv::Size sz, const cv::Rect &face, bool hasFac
     return m;
 }
 
+/*
+ * GrabCut 반복(from→to 진행률, 취소 확인). job.models를 작업 모델로 사용
+ * - OpenCv: ctl이 있으면 한 번씩 나눠 실행(GC_EVAL로 이어서 수행, 결과 동일), 항상 iters회
+ * - Parallel: 반복마다 라벨 변화 비율을 보고 수렴하면 조기 종료. 그래프 메모리는 job.segmenter 것을 재사용
+ */
+bool SuitComposer::runGrabCut(const Mat &img, Mat &mask, SegmentJob &job, int iters, int mode, int from, int to)
+{
+    const ComposeControl *ctl = job.ctl;
+    if (job.engine == SegmentEngine::Parallel)
+    {
+        CV_Assert(job.segmenter);
+        GraphCutSegmenter &segmenter = *job.segmenter;
+        segmenter.setConvergence(job.convergence);
+        segmenter.begin(img, mask, job.models.bg, job.models.fg, mode);
+        for (int i = 0; i < iters; ++i)
+        {
+            const bool converged = segmenter.iterate();
+            if (ctl)
+            {
+                ctl->report(from + (to - from) * (i + 1) / iters);
+                if (ctl->isCancelled())
+                    return false;
+            }
+            if (converged)
+                break;
+        }
+        job.stats.iterations += segmenter.stats().iterations;
+        job.stats.ms += segmenter.stats().ms;
+        if (ctl)
+            ctl->report(to);
+        return true;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    if (!ctl)
+        grabCut(img, mask, Rect(), job.models.bg, job.models.fg, iters, mode);
+    for (int i = 0; ctl && i < iters; ++i)
+    {
+        grabCut(img, mask, Rect(), job.models.bg, job.models.fg, 1, i == 0 ? mode : GC_EVAL);
+        ctl->report(from + (to - from) * (i + 1) / iters);
+        if (ctl->isCancelled())
+            return false;
+    }
+    job.stats.iterations += iters;
+    job.stats.ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return true;
+}
+
 /* GrabCut 실행 → 전경(확정/추정)을 255로 하는 이진 알파 반환 */
-void SuitComposer::makeAlphaByGrabCut(const Mat &bgr, const Mat &trimap, Mat &alphaOut, int iters)
+bool SuitComposer::makeAlphaByGrabCut(const Mat &bgr, const Mat &trimap, Mat &alphaOut, SegmentJob &job)
 {
-    Mat mask = trimap.clone(), bgModel, fgModel;
-    grabCut(bgr, mask, Rect(), bgModel, fgModel, iters, GC_INIT_WITH_MASK);
+    Mat mask = trimap.clone();
+    if (!runGrabCut(bgr, mask, job, job.iters, job.models.empty() ? GC_INIT_WITH_MASK : GC_EVAL, 15, 80))
+        return false;
     alphaOut = Mat(bgr.size(), CV_8U, Scalar(0));
     alphaOut.setTo(255, (mask == GC_FGD) | (mask == GC_PR_FGD));
+    return true;
+}
+
+/*
+ * 다중 해상도 ROI GrabCut
+ * 1) 전경 후보(FGD/PR_FGD) 외접 사각형 + 여백으로 ROI 제한(목선 아래는 어차피 잘리므로 제외)
+ * 2) ROI를 1/2로 줄여 전체 반복
+ * 3) 원 해상도에서는 경계 띠만 추정 라벨, 나머지는 확정으로 두고 저해상도 모델로 1회 정제
+ * ROI 밖은 배경(알파 0)
+ */
+bool SuitComposer::makeAlphaByRoiGrabCut(const Mat &bgr, const Mat &trimap, int neckY, Mat &alphaOut, SegmentJob &job)
+{
+    const Rect box = boundingRect((trimap == GC_FGD) | (trimap == GC_PR_FGD));
+    if (box.area() == 0)
+        return makeAlphaByGrabCut(bgr, trimap, alphaOut, job);
+    const int margin = std::max(8, std::max(box.width, box.height) / 4);
+    Rect roi(box.x - margin, box.y - margin, box.width + 2 * margin, box.height + 2 * margin);
+    if (neckY > 0)
+        roi.height = std::min(roi.height, neckY + margin / 2 - roi.y);
+    roi &= Rect(0, 0, bgr.cols, bgr.rows);
+    if (roi.width < 32 || roi.height < 32) // 너무 작으면 저해상도 의미 없음
+        return makeAlphaByGrabCut(bgr, trimap, alphaOut, job);
+
+    const Mat img = bgr(roi), tri = trimap(roi);
+
+    // 1/2 해상도 전체 반복
+    Mat imgLo, maskLo;
+    resize(img, imgLo, Size(), 0.5, 0.5, INTER_AREA);
+    resize(tri, maskLo, imgLo.size(), 0, 0, INTER_NEAREST);
+    if (!runGrabCut(imgLo, maskLo, job, job.iters, job.models.empty() ? GC_INIT_WITH_MASK : GC_EVAL, 15, 70))
+        return false;
+
+    // 원 해상도 정제 마스크: 경계 ±band 픽셀만 추정, 안쪽/바깥쪽은 확정, 얼굴 타원은 원래대로 확정
+    constexpr int band = 4;
+    Mat fg;
+    resize((maskLo == GC_FGD) | (maskLo == GC_PR_FGD), fg, img.size(), 0, 0, INTER_NEAREST);
+    const Mat k = getStructuringElement(MORPH_ELLIPSE, Size(2 * band + 1, 2 * band + 1));
+    Mat inner, outer;
+    erode(fg, inner, k);
+    dilate(fg, outer, k);
+    Mat mask(img.size(), CV_8U, Scalar(GC_BGD));
+    mask.setTo(GC_PR_BGD, outer);
+    mask.setTo(GC_PR_FGD, fg);
+    mask.setTo(GC_FGD, inner);
+    mask.setTo(GC_FGD, tri == GC_FGD);
+    if (!runGrabCut(img, mask, job, 1, GC_EVAL, 70, 80))
+        return false;
+
+    alphaOut = Mat(bgr.size(), CV_8U, Scalar(0));
+    alphaOut(roi).setTo(255, (mask == GC_FGD) | (mask == GC_PR_FGD));
+    return true;
+}
+
+/*
+ * 클린 플레이트 매팅
+ * 1) 두 영상을 살짝 블러 → 채널 최대 색 차(행 병렬 SIMD)
+ * 2) 테두리 띠(대부분 배경)의 색 차 중앙값으로 잡음 추정 → lo/hi를 그 이상으로 올림(노출 변화 흡수)
+ * 3) 램프 → 이진화 → OPEN/CLOSE → 가장 큰 덩어리만, 구멍 메움
+ */
+bool SuitComposer::makeAlphaByCleanPlate(const Mat &bgr, const Mat &plate, int lo, int hi, Mat &alphaOut)
+{
+    CV_Assert(bgr.size() == plate.size() && bgr.type() == CV_8UC3 && plate.type() == CV_8UC3);
+    Mat a, b;
+    GaussianBlur(bgr, a, Size(5, 5), 0);
+    GaussianBlur(plate, b, Size(5, 5), 0);
+    Mat d(bgr.size(), CV_8U);
+    parallel_for_(Range(0, d.rows), [&](const Range &r) {
+        for (int y = r.start; y < r.end; ++y)
+            plateDiffRow(a.ptr<uchar>(y), b.ptr<uchar>(y), d.ptr<uchar>(y), d.cols);
+    });
+
+    // 테두리 잡음 중앙값(폭 = 짧은 변의 1/16)
+    const int band = std::max(2, std::min(d.cols, d.rows) / 16);
+    int hist[256] = {}, total = 0;
+    for (int y = 0; y < d.rows; ++y)
+    {
+        const uchar *p = d.ptr<uchar>(y);
+        const bool edgeRow = y < band || y >= d.rows - band;
+        for (int x = 0; x < d.cols; ++x)
+            if (edgeRow || x < band || x >= d.cols - band)
+            {
+                ++hist[p[x]];
+                ++total;
+            }
+    }
+    int median = 0;
+    for (int acc = 0; median < 255 && (acc += hist[median]) < total / 2;)
+        ++median;
+    lo = std::min(239, std::max(lo, 3 * median));
+    hi = std::min(255, std::max(hi, lo + 16));
+    parallel_for_(Range(0, d.rows), [&](const Range &r) {
+        for (int y = r.start; y < r.end; ++y)
+            plateRampRow(d.ptr<uchar>(y), d.cols, lo, hi);
+    });
+
+    Mat fg;
+    threshold(d, fg, 127, 255, THRESH_BINARY);
+    morphologyEx(fg, fg, MORPH_OPEN, getStructuringElement(MORPH_ELLIPSE, Size(5, 5)));
+    morphologyEx(fg, fg, MORPH_CLOSE, getStructuringElement(MORPH_ELLIPSE, Size(9, 9)));
+
+    // 가장 큰 연결 요소(사람)만 남김
+    Mat labels, stats, centroids;
+    const int n = connectedComponentsWithStats(fg, labels, stats, centroids, 8, CV_32S);
+    int best = 0;
+    for (int i = 1; i < n; ++i)
+        if (best == 0 || stats.at<int>(i, CC_STAT_AREA) > stats.at<int>(best, CC_STAT_AREA))
+            best = i;
+    const double ratio = best > 0 ? double(stats.at<int>(best, CC_STAT_AREA)) / fg.total() : 0.0;
+    if (ratio < 0.03 || ratio > 0.85) // 사람이 없거나 배경 전체가 달라짐
+        return false;
+    fg = labels == best;
+
+    // 구멍 메움: 테두리에서 닿지 않는 배경을 전경으로
+    Mat outside(fg.rows + 2, fg.cols + 2, CV_8U, Scalar(0));
+    fg.copyTo(outside(Rect(1, 1, fg.cols, fg.rows)));
+    floodFill(outside, Point(0, 0), Scalar(255));
+    alphaOut = fg | ~outside(Rect(1, 1, fg.cols, fg.rows));
+    return true;
 }
 
 /* Mat → QImage 변환(BGR/RGBA 전용) */
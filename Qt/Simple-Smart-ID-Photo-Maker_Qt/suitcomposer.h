@@ -1,9 +1,44 @@
 #ifndef SUITCOMPOSER_H
 #define SUITCOMPOSER_H
 
+#include "framecontext.h"
+#include "graphcutsegmenter.h"
+#include <QMutex>
 #include <QObject>
+#include <QStringList>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <opencv2/opencv.hpp>
 
+// 합성 진행률 보고/취소 확인 훅(백그라운드 합성용, 둘 다 선택)
+struct ComposeControl
+{
+    std::function<void(int)> progress; // 0~100
+    std::function<bool()> cancelled;   // true면 다음 단계에서 중단
+
+    void report(int percent) const
+    {
+        if (progress)
+            progress(percent);
+    }
+    bool isCancelled() const { return cancelled && cancelled(); }
+};
+
+// 백그라운드에서 읽어 둔 합성 리소스(GUI 스레드에서 setAssets로 적용)
+struct SuitAssets
+{
+    cv::Mat suitRGBA;  // 캔버스 크기 RGBA(실패 시 빈 Mat)
+    cv::Mat suitFullRGBA; // 원본 해상도 RGBA(고해상도 출력용)
+    cv::Mat guideRGBA; // 옵션(알파 전부 0이면 빈 Mat)
+    cv::CascadeClassifier faceDet;
+    cv::CascadeClassifier trackerDet; // 프리뷰 얼굴 추적용(GUI 스레드 공유 인스턴스, faceDet와 사용 스레드가 다름)
+    bool hasCascade = false;
+    cv::Mat cleanPlate; // 옵션(저장된 클린 플레이트, 있으면 CleanPlate 분할)
+    QStringList warnings;
+};
+
 class SuitComposer : public QObject
 {
     Q_OBJECT
@@ -15,6 +50,13 @@ class SuitComposer : public QObject
     // 리소스 로드
     bool loadSuit(const QString &path);
     bool loadGuide(const QString &path);
+    bool loadFaceCascade();
+
+    // 리소스 일괄 로드(시그널 없음, 모델 로드를 기다리므로 작업 스레드에서)
+    static SuitAssets loadAssets(const QString &suitPath, const QString &guidePath, cv::Size canvas);
+    // loadAssets 결과 적용. 수트가 있으면 true
+    bool setAssets(SuitAssets assets);
+    bool isReady() const { return !suitRGBA_.empty(); }
 
     // 상태 제어
     void setMirror(bool on);
@@ -22,14 +64,110 @@ class SuitComposer : public QObject
     void setGuideOpacity(double a01);
     void setBackgroundColor(const cv::Scalar &color);
 
-    // 프리뷰 생성: 입력 BGR 프레임 -> 미러/리사이즈/가이드 오버레이된 BGR 반환
-    cv::Mat makePreviewBGR(const cv::Mat &frameBGR) const;
+    // 얼굴 알파 분할 방식
+    enum class SegmentMode
+    {
+        FullGrabCut, // 캔버스 전체에 GrabCut
+        RoiMultiRes, // 전경 후보 ROI만, 1/2 해상도로 풀고 경계 띠만 원 해상도로 정제(기본)
+        CleanPlate   // 빈 배경 사진과의 색 차(플레이트가 없거나 결과가 비정상이면 RoiMultiRes)
+    };
+    void setSegmentMode(SegmentMode mode);
+    SegmentMode segmentMode() const;
+
+    // 그래프 컷 엔진
+    enum class SegmentEngine
+    {
+        OpenCv,  // cv::grabCut(단일 스레드, 고정 반복)
+        Parallel // GraphCutSegmenter(병렬 GMM, 라벨 변화가 수렴 기준 미만이면 조기 종료, 기본)
+    };
+    void setSegmentEngine(SegmentEngine engine);
+    SegmentEngine segmentEngine() const;
+    // Parallel 엔진 수렴 기준(추정 픽셀 중 라벨이 바뀐 비율)
+    void setSegmentConvergence(double ratio);
+
+    // 클린 플레이트: 사람이 없는 배경 프레임(카메라 원본 좌표, 미러 전). 빈 Mat이면 해제
+    // 색 차 임계값 lo/hi(채널 최대 차): lo 이하 배경, hi 이상 전경. 합성 시에는 테두리 잡음에 맞춰 올림
+    void setCleanPlate(const cv::Mat &frameBGR);
+    bool hasCleanPlate() const;
+    void setCleanPlateThresholds(int lo, int hi);
+
+    // 출력 해상도: 분할은 캔버스(W_xH_)에서 하고, 알파는 가이드 업샘플로 캔버스 x 배율 크기까지 올려
+    // 원본 프레임/원본 수트로 합성. 배율 = min(프레임이 허용하는 배율, 수트 원본 배율, maxScale), 1이면 캔버스 크기 출력
+    // 수트는 확대하지 않으므로 캔버스 크기 수트(기본 300x400 에셋)면 출력도 캔버스 크기
+    void setMaxOutputScale(double maxScale);
+    cv::Size outputSizeFor(cv::Size frameSize) const;
+
+    // 합성 작업 하나가 쓰는 설정 스냅샷. 작업을 제출하는 쪽(GUI 스레드)이 settings()로 떠서 넘기고
+    // 작업 스레드는 이것만 읽음(설정 멤버/검출기는 건드리지 않음)
+    struct Settings
+    {
+        int W = 300, H = 400, neckY = 290;
+        bool mirror = true;
+        cv::Scalar backgroundColor;
+        SegmentMode mode = SegmentMode::RoiMultiRes;
+        SegmentEngine engine = SegmentEngine::Parallel;
+        double convergence = 0.001;
+        double maxOutputScale = 4.0;
+        cv::Mat suitRGBA, suitFullRGBA;                // 공유 버퍼(교체만 하고 내용은 고치지 않음)
+        std::shared_ptr<cv::CascadeClassifier> faceDet; // 합성 스레드 전용 인스턴스(없으면 중앙 박스)
+    };
+    Settings settings() const;
+
+    // 실시간 얼굴 추적 결과(카메라 원본 좌표를 0~1로 정규화, 미러 전). 어느 스레드에서나 호출 가능
+    // 합성 시 신뢰도가 충분하고 최근 값이면 전체 검출 대신 그 주변 ROI만 검출. confidence 0이면 해제
+    void setFaceHint(const cv::Rect2f &normRect, float confidence);
 
-    // 얼굴 알파 생성 + 수트 합성 RGBA 반환
-    cv::Mat composeRGBA(const cv::Mat &frameBGR);
+    // 마지막 합성의 분할 통계(모든 단계 합계). 어느 스레드에서나 호출 가능
+    struct SegmentStats
+    {
+        int iterations = 0;
+        double ms = 0.0;
+        bool warm = false; // 직전 촬영 모델로 시작했는지
+    };
+    SegmentStats lastSegmentStats() const;
+
+    // 재촬영 가속: 직전 촬영의 GrabCut 색 모델로 시작해 반복 횟수를 줄임
+    // 얼굴/배경 색 평균이 달라지거나 오래되면 자동 폐기. 어느 스레드에서나 호출 가능
+    void setWarmStartEnabled(bool on);
+    void resetWarmStart(); // 세션 종료(다음 손님) 시 호출
+
+    // 실시간 배경 제거 프리뷰: 색 모델(마지막 촬영 또는 warmUpLiveMatte)로 만든 32³ RGB 전경 확률 표로
+    // 매 프레임 알파를 구하고(앞 프레임과 평균) 선택 배경색 위에 얼굴, 그 위에 수트를 합성
+    // 표가 준비되기 전에는 가이드 프리뷰. resetWarmStart()로 함께 폐기
+    void setLiveMatte(bool on) { liveMatte_ = on; }
+    bool liveMatte() const { return liveMatte_; }
+    bool hasLiveMatteModel() const;
+    // 한 프레임으로 분할만 수행해 실시간 표 준비(합성 작업 스레드에서 호출, ctl로 취소)
+    // 촬영용 직전 모델 캐시와 분할 통계는 읽지도 바꾸지도 않음
+    bool warmUpLiveMatte(const cv::Mat &frameBGR, const Settings &settings, const ComposeControl *ctl = nullptr);
+
+    // 프리뷰 가이드 표시 방식: 반투명 합성 또는 외곽선만(저사양용)
+    enum class GuideStyle
+    {
+        Blend,
+        Outline
+    };
+
+    // 프리뷰 생성: 입력 BGR 프레임 -> 미러/리사이즈/가이드 오버레이된 BGR을 out에 기록
+    // - out이 같은 크기면 버퍼 재사용, 미러는 리샘플 맵에 포함, 가이드는 캐시된 프리멀티플라이 가이드로 합성
+    // - scale: 캔버스 대비 출력 배율(1.0 = W_xH_). 캐시를 쓰므로 한 스레드(GUI)에서만 호출
+    void makePreview(const cv::Mat &frameBGR, cv::Mat &out, double scale = 1.0, GuideStyle style = GuideStyle::Blend) const;
+    // 새 Mat으로 반환하는 버전
+    cv::Mat makePreviewBGR(const cv::Mat &frameBGR, double scale = 1.0, GuideStyle style = GuideStyle::Blend) const;
+
+    // 얼굴 알파 생성 + 수트 합성 RGBA 반환(ctl로 취소되면 빈 Mat). 작업 스레드에서는 스냅샷 버전으로
+    cv::Mat composeRGBA(const cv::Mat &frameBGR, const Settings &settings, const ComposeControl *ctl = nullptr);
+    cv::Mat composeRGBA(const cv::Mat &frameBGR, const ComposeControl *ctl = nullptr) { return composeRGBA(frameBGR, settings(), ctl); }
 
     // 배경색이 적용된 BGR 이미지 반환 (투명 배경 대신)
-    cv::Mat composeBGR(const cv::Mat &frameBGR);
+    cv::Mat composeBGR(const cv::Mat &frameBGR, const ComposeControl *ctl = nullptr);
+
+    // RGBA 합성 결과를 단색 배경 위에 평탄화한 BGR 반환
+    static cv::Mat flattenRGBA(const cv::Mat &rgba, const cv::Scalar &bgColor);
+    // 평탄화된 BGR의 배경색 교체(합성 알파 기준, 재분할 없음): out = bgr + (to - from)*(255-a)/255
+    // out은 bgr과 같아도 됨. 편집 후 영상에도 적용은 되지만 보정(선명도·눈 크기 등)으로 바뀐 배경/경계 픽셀은
+    // 그 차이가 그대로 남음(알파 0이라도 값이 from이 아니면 결과도 정확히 to가 아님)
+    static void rebaseBackground(const cv::Mat &bgr, const cv::Mat &alpha, const cv::Scalar &from, const cv::Scalar &to, cv::Mat &out);
 
     // 유틸: Mat<->QImage 변환
     static QImage matBGR2QImage(const cv::Mat &bgr);
@@ -41,25 +179,114 @@ class SuitComposer : public QObject
     void error(const QString &s);
 
   private:
-    static void alphaOverRGBA(const cv::Mat &fgRGBA, const cv::Mat &bgRGBA, cv::Mat &outRGBA);
-    static void overlayRGBA(cv::Mat &bgr, const cv::Mat &rgba, double opacity);
+    // GrabCut 색 모델(배경/전경 GMM, 각 1x65 CV_64F)
+    struct GrabCutModels
+    {
+        cv::Mat bg, fg;
+        bool empty() const { return bg.empty() || fg.empty(); }
+    };
+
+    // 알파 없으면 255 추가, 캔버스 크기로 보정(original이 있으면 보정 전 원본도)
+    static cv::Mat readRGBA(const QString &path, cv::Size canvas, cv::Mat *original = nullptr);
+    static bool hasVisibleAlpha(const cv::Mat &rgba);
     static cv::Mat buildTrimap(cv::Size sz, const cv::Rect &face, bool hasFace);
-    static void makeAlphaByGrabCut(const cv::Mat &bgr, const cv::Mat &trimap, cv::Mat &alphaOut, int iters = 6);
-    static cv::Rect detectLargestFace(const cv::Mat &viewBGR, cv::CascadeClassifier *det);
+
+    // 분할 한 번의 설정과 결과(합성 스레드 지역)
+    struct SegmentJob
+    {
+        SegmentEngine engine = SegmentEngine::Parallel;
+        double convergence = 0.001;
+        int iters = 6; // 최대 반복 수
+        const ComposeControl *ctl = nullptr;
+        GraphCutSegmenter *segmenter = nullptr; // Parallel 엔진(SuitComposer 소유, 작업 사이 그래프 메모리 재사용)
+        GrabCutModels models; // 비어 있지 않으면 그 모델로 시작(GC_EVAL), 끝나면 학습된 모델로 갱신
+        SegmentStats stats;   // 단계별 누적
+    };
+    static bool runGrabCut(const cv::Mat &img, cv::Mat &mask, SegmentJob &job, int iters, int mode, int from, int to);
+    static bool makeAlphaByGrabCut(const cv::Mat &bgr, const cv::Mat &trimap, cv::Mat &alphaOut, SegmentJob &job);
+    static bool makeAlphaByRoiGrabCut(const cv::Mat &bgr, const cv::Mat &trimap, int neckY, cv::Mat &alphaOut, SegmentJob &job);
+    // 플레이트 색 차 알파(0/255). 전경 면적이 비정상이면 false(조명 변화/카메라 이동 → GrabCut으로)
+    static bool makeAlphaByCleanPlate(const cv::Mat &bgr, const cv::Mat &plate, int lo, int hi, cv::Mat &alphaOut);
+    static cv::Rect detectLargestFace(FrameContext &view, cv::CascadeClassifier *det);
+    static cv::Mat makeView(const cv::Mat &frameBGR, const Settings &s); // 미러 + 캔버스 크기
+    static cv::Size outputSizeFor(const Settings &s, cv::Size frameSize);
+    // 분할 용도: 촬영은 직전 모델 캐시/통계를 쓰고 갱신, 실시간 매트 준비는 실시간 표만 갱신
+    enum class SegmentUse
+    {
+        Capture,
+        LiveWarmUp
+    };
+    // 얼굴 검출 → 트라이맵 → 분할(용도에 따라 직전 모델 재사용, 통계/실시간 표 갱신). 취소되면 빈 Mat
+    cv::Mat segmentView(FrameContext &viewCtx, const Settings &s, const ComposeControl *ctl, SegmentUse use = SegmentUse::Capture);
 
   private:
+    // 합성 설정(GUI 스레드가 바꾸고 settings()가 settingsMutex_ 아래 복사). 프리뷰는 GUI 스레드에서 직접 읽음
+    mutable QMutex settingsMutex_;
     int W_ = 300, H_ = 400, neckY_ = 290;
     bool mirror_ = true;
     bool showGuide_ = true;
     double guideOpacity_ = 0.7;
 
     cv::Mat suitRGBA_;  // 캔버스 크기 보장
+    cv::Mat suitFullRGBA_; // 원본 해상도(없으면 suitRGBA_)
+    double maxOutputScale_ = 4.0;
     cv::Mat guideRGBA_; // 옵션
     bool guideOK_ = false;
 
-    cv::CascadeClassifier faceDet_;
-    bool hasCascade_ = false;
+    // 프리뷰 캐시: 입력/출력 크기, 미러, 가이드, 불투명도가 바뀔 때만 다시 만듦
+    struct PreviewCache
+    {
+        cv::Size src, out;
+        bool mirror = false;
+        cv::Mat map1, map2; // 미러 포함 리샘플 맵(고정소수점)
+        cv::Size guideSize;
+        double guideOpacity = -1.0;
+        cv::Mat guidePremul;  // 8UC4: B*a/255, G*a/255, R*a/255, 255-a (a = 가이드 알파 * 불투명도)
+        cv::Mat guideOutline; // 가이드 알파 외곽선 마스크
+        cv::Size suitSize;
+        cv::Mat suitPremul;   // 실시간 매트용 수트(guidePremul과 같은 배치, 불투명도 1)
+        cv::Mat liveAlpha;    // 앞 프레임 알파(시간 평활)
+        std::shared_ptr<const cv::Mat> liveLut; // liveAlpha를 만든 표/플레이트(바뀌면 평활 초기화)
+        cv::Mat plate;                               // 프리뷰 좌표로 리샘플한 클린 플레이트(맵이 바뀌면 초기화)
+        std::shared_ptr<const cv::Mat> plateSource; // plate를 만든 원본
+    };
+    mutable PreviewCache preview_;
+    void invalidateGuideCache();
+    void preparePreviewMaps(cv::Size src, cv::Size out) const;
+    void prepareGuide(cv::Size size) const;
+    void prepareSuit(cv::Size size) const;
+
+    std::shared_ptr<cv::CascadeClassifier> faceDet_; // 바꿀 때는 새 인스턴스로 교체(작업이 쥔 것은 그대로)
     cv::Scalar backgroundColor_ = cv::Scalar(255, 255, 255); // 기본 흰색 배경
+    SegmentMode segmentMode_ = SegmentMode::RoiMultiRes;
+    SegmentEngine segmentEngine_ = SegmentEngine::Parallel;
+    double segmentConvergence_ = 0.001;
+
+    // 세션 단위 색 모델 캐시(합성 작업 스레드와 GUI 스레드가 공유)
+    struct WarmStart
+    {
+        GrabCutModels models;
+        cv::Scalar fgMean, bgMean; // 모델을 학습한 촬영의 얼굴/배경 색 평균
+        std::chrono::steady_clock::time_point time;
+    };
+    mutable QMutex warmMutex_; // warm_, lastStats_ 보호
+    WarmStart warm_;
+    bool warmStartEnabled_ = true;
+    SegmentStats lastStats_;
+
+    // Parallel 엔진 인스턴스(합성 작업이 하나씩 빌려 씀)
+    QMutex segmenterMutex_;
+    GraphCutSegmenter segmenter_;
+
+    // 실시간 매트 표/클린 플레이트(한 스레드가 교체, 다른 스레드는 참조를 잡고 사용)
+    bool liveMatte_ = false;
+    mutable QMutex liveMutex_;
+    std::shared_ptr<const cv::Mat> liveLut_;
+    std::shared_ptr<const cv::Mat> cleanPlate_; // 카메라 원본 좌표 BGR
+    int plateLo_ = 20, plateHi_ = 48;
+    cv::Rect2f faceHint_; // 정규화 좌표(liveMutex_ 보호)
+    float faceHintConfidence_ = 0.f;
+    std::chrono::steady_clock::time_point faceHintTime_;
 };
 
 #endif // SUITCOMPOSER_H
@@ -0,0 +1,67 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+/*
+ * 단일 생산자/단일 소비자용 락프리 트리플 버퍼
+ * - 생산자는 back 슬롯에 쓰고 publish()로 middle 슬롯과 교환
+ * - 소비자는 update()로 새 middle 슬롯을 front로 가져옴(최신 값만 유지)
+ * - 어느 쪽도 상대를 기다리지 않으며, 느린 소비자는 중간 프레임을 건너뜀
+ */
+template <typename T> class TripleBuffer
+{
+  public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    // 생산자 전용: 현재 쓰기 슬롯
+    T &writeSlot() { return slots_[back_]; }
+
+    // 생산자 전용: 쓰기 완료 슬롯을 공개하고 비어 있는 슬롯을 다음 쓰기용으로 회수
+    void publish()
+    {
+        const std::uint8_t prev = state_.exchange(std::uint8_t(back_ | kDirty), std::memory_order_acq_rel);
+        back_ = prev & kIndexMask;
+    }
+
+    // 소비자 전용: 새 값이 있으면 front로 가져오고 true 반환
+    bool update()
+    {
+        if (!(state_.load(std::memory_order_acquire) & kDirty))
+            return false;
+        const std::uint8_t prev = state_.exchange(front_, std::memory_order_acq_rel);
+        front_ = prev & kIndexMask;
+        return true;
+    }
+
+    // 소비자 전용: 마지막으로 가져온 값(다음 update() 전까지 유효)
+    T &readSlot() { return slots_[front_]; }
+    const T &readSlot() const { return slots_[front_]; }
+
+    // 양쪽 모두 멈춘 상태에서만: 모든 슬롯을 비우고 초기 상태로
+    void reset()
+    {
+        for (T &slot : slots_)
+            slot = T();
+        state_.store(1, std::memory_order_relaxed);
+        back_ = 0;
+        front_ = 2;
+    }
+
+    // 소비자가 아직 가져가지 않은 새 값이 있는지
+    bool hasNew() const { return state_.load(std::memory_order_acquire) & kDirty; }
+
+  private:
+    static constexpr std::uint8_t kIndexMask = 0x3;
+    static constexpr std::uint8_t kDirty = 0x4;
+
+    T slots_[3];
+    std::atomic<std::uint8_t> state_{1}; // middle 슬롯 인덱스 | dirty 비트
+    std::uint8_t back_ = 0;              // 생산자 소유
+    std::uint8_t front_ = 2;             // 소비자 소유
+};
+
+#endif // TRIPLEBUFFER_H
@@ -0,0 +1,158 @@
+/*
+ * shm_frame_writer.cpp
+ *
+ * 외부 캡처 프로세스 대용: 카메라/동영상/합성 프레임을 POSIX 공유 메모리 프레임 링에 씀
+ * Qt 앱은 --source shm:/idphoto_frames 로 복사 없이 읽음(레이아웃: shmframering.h)
+ *
+ * 입력 인자
+ *   argv[1] : 공유 메모리 이름 (기본 /idphoto_frames)
+ *   argv[2] : 입력 - 카메라 번호, 동영상 경로 또는 synthetic (기본 0)
+ *   argv[3] : 출력 fps (기본 30)
+ *   argv[4] : 링 슬롯 수 (기본 8)
+ *
+ * 종료: Ctrl+C (공유 메모리 이름 제거 후 종료)
+ */
+
+#include "../Qt/Simple-Smart-ID-Photo-Maker_Qt/shmframering.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace cv;
+using namespace std;
+
+static volatile sig_atomic_t g_stop = 0;
+static void onSignal(int) { g_stop = 1; }
+
+/* 합성 입력: 움직이는 원 + 프레임 번호 */
+static void makeSyntheticFrame(Mat &frame, uint64_t n)
+{
+    frame.create(480, 640, CV_8UC3);
+    frame.setTo(Scalar(200, 190, 180));
+    const int x = 320 + int(60 * sin(n * 0.05));
+    circle(frame, Point(x, 200), 80, Scalar(130, 165, 215), FILLED, LINE_AA);
+    ellipse(frame, Point(x, 480), Size(220, 180), 0, 180, 360, Scalar(60, 50, 45), FILLED, LINE_AA);
+    putText(frame, to_string(n), Point(10, 30), FONT_HERSHEY_SIMPLEX, 0.8, Scalar(0, 0, 0), 2);
+}
+
+int main(int argc, char **argv)
+{
+    const string name = (argc >= 2) ? argv[1] : "/idphoto_frames";
+    const string input = (argc >= 3) ? argv[2] : "0";
+    const double fps = (argc >= 4) ? atof(argv[3]) : 30.0;
+    const uint32_t slotCount = (argc >= 5) ? uint32_t(max(2, atoi(argv[4]))) : 8u;
+
+    // 입력 오픈
+    const bool synthetic = (input == "synthetic");
+    VideoCapture cap;
+    if (!synthetic)
+    {
+        const bool isIndex = !input.empty() && input.find_first_not_of("0123456789") == string::npos;
+        if (isIndex)
+            cap.open(atoi(input.c_str()), CAP_V4L2);
+        else
+            cap.open(input, CAP_ANY);
+        if (!cap.isOpened())
+        {
+            fprintf(stderr, "source open fail: %s\n", input.c_str());
+            return 2;
+        }
+    }
+
+    // 첫 프레임으로 링 형식 결정
+    Mat frame;
+    if (synthetic)
+        makeSyntheticFrame(frame, 1);
+    else if (!cap.read(frame) || frame.empty())
+    {
+        fprintf(stderr, "first frame read fail\n");
+        return 2;
+    }
+    const uint32_t width = uint32_t(frame.cols), height = uint32_t(frame.rows);
+    const size_t stride = shmring::alignUp(size_t(width) * 3);
+    const size_t slotBytes = shmring::slotBytes(stride, height);
+    const size_t total = shmring::totalBytes(slotCount, slotBytes);
+
+    // 공유 메모리 생성 + 매핑
+    shm_unlink(name.c_str()); // 이전 실행 잔여물 제거
+    const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0660);
+    if (fd < 0 || ftruncate(fd, off_t(total)) != 0)
+    {
+        perror("shm_open/ftruncate");
+        return 1;
+    }
+    void *base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        perror("mmap");
+        shm_unlink(name.c_str());
+        return 1;
+    }
+
+    // 헤더 초기화(magic은 마지막에 기록 → 소비자는 완성된 헤더만 인정)
+    auto *h = new (base) shmring::Header();
+    h->version = shmring::kVersion;
+    h->slotCount = slotCount;
+    h->width = width;
+    h->height = height;
+    h->cvType = CV_8UC3;
+    h->stride = uint32_t(stride);
+    h->slotBytes = slotBytes;
+    h->latest.store(0, memory_order_relaxed);
+    for (uint32_t i = 0; i < slotCount; ++i)
+        new (shmring::slotAt(base, *h, i + 1)) shmring::SlotHeader();
+    atomic_thread_fence(memory_order_release);
+    h->magic = shmring::kMagic;
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    printf("[info] %s: %ux%u BGR, %u slots, %.1f fps, %zu bytes\n", name.c_str(), width, height, slotCount, fps, total);
+
+    const auto period = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(1.0 / max(1.0, fps)));
+    auto next = chrono::steady_clock::now();
+    for (uint64_t n = 1; !g_stop; ++n)
+    {
+        if (n > 1)
+        {
+            if (synthetic)
+                makeSyntheticFrame(frame, n);
+            else if (!cap.read(frame) || frame.empty())
+            {
+                // 동영상 끝 → 처음으로
+                if (!cap.set(CAP_PROP_POS_FRAMES, 0) || !cap.read(frame) || frame.empty())
+                    break;
+            }
+        }
+        if (frame.cols != int(width) || frame.rows != int(height))
+            resize(frame, frame, Size(int(width), int(height)));
+        if (frame.channels() == 1)
+            cvtColor(frame, frame, COLOR_GRAY2BGR);
+
+        // seqlock 쓰기: 홀수(쓰는 중) → 픽셀 → 짝수(완료) → latest 공개
+        shmring::SlotHeader *s = shmring::slotAt(base, *h, n);
+        s->seq.store(2 * n - 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        Mat dst(int(height), int(width), CV_8UC3, shmring::pixels(s), stride);
+        frame.copyTo(dst);
+        s->frame = n;
+        s->timestampNs = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+        s->seq.store(2 * n, memory_order_release);
+        h->latest.store(n, memory_order_release);
+
+        next += period;
+        this_thread::sleep_until(next);
+    }
+
+    munmap(base, total);
+    shm_unlink(name.c_str());
+    printf("[info] stopped\n");
+    return 0;
+}
@@ -18,11 +18,19 @@
  * 입력 인자
  *   argv[1] : 수트 이미지 경로 (기본 ../image/man_suit_bg_remove_3.png)
  *   argv[2] : 가이드 이미지 경로 (기본 ../image/man_suit_bg_remove_3.png)
+ *   argv[3] : (make FRAMESOURCE=1 빌드만) 프레임 공급원 스펙(Qt 앱 --source와 같은 형식, 선택)
+ *             v4l2[:N] | file:경로 | images:디렉터리 | synthetic[:WxH] | shm:이름, 뒤에 @fps
+ *             생략하면 카메라 0, 안 열리면 1
  *
  * 빌드 예시
- *   g++ -std=c++17 -O2 main.cpp `pkg-config --cflags --libs opencv4` -o webcam_suit
+ *   make                (OpenCV만, 카메라 0 → 1 → 기본 백엔드 순서로 시도)
+ *   make FRAMESOURCE=1  (Qt 앱의 framesource.cpp를 함께 빌드, QtCore 필요)
  */
 
+#include "alphaover.h"
+#ifdef WITH_FRAMESOURCE
+#include "framesource.h"
+#endif
 #include <algorithm>
 #include <ctime>
 #include <filesystem>
@@ -42,60 +50,6 @@ static string nowstamp()
     return b;
 }
 
-/*
- * 비프리멀티플라이(Non-premultiplied) RGBA 합성: out = fg ⊕ bg
- * - 입력: 동일 크기의 8UC4(fg, bg)
- * - 출력: outRGBA = 포어그라운드가 백그라운드 위에 얹힌 결과
- * - 수식:
- *     A_out = Af + Ab * (1 - Af)
- *     C_out = (Cf*Af + Cb*Ab*(1 - Af)) / max(A_out, eps)
- *   여기서 A, C는 각각 알파와 RGB 채널, 범위는 [0,1]
- */
-static void alphaOverRGBA(const Mat &fgRGBA, const Mat &bgRGBA, Mat &outRGBA)
-{
-    CV_Assert(fgRGBA.type() == CV_8UC4 && bgRGBA.type() == CV_8UC4 && fgRGBA.size() == bgRGBA.size());
-
-    // 채널 분리: fgc[0..2]=BGR, fgc[3]=A
-    vector<Mat> fgc, bgc;
-    split(fgRGBA, fgc);
-    split(bgRGBA, bgc);
-
-    // 알파를 float [0,1]로 변환
-    Mat af32, ab32;
-    fgc[3].convertTo(af32, CV_32F, 1.0 / 255.0);
-    bgc[3].convertTo(ab32, CV_32F, 1.0 / 255.0);
-
-    // A_out = Af + Ab * (1 - Af)
-    Mat outA32 = af32 + ab32.mul(1.0f - af32);
-
-    vector<Mat> out(4);
-    for (int c = 0; c < 3; c++)
-    {
-        // 컬러 채널을 float로
-        Mat F, B, Fo;
-        fgc[c].convertTo(F, CV_32F);
-        bgc[c].convertTo(B, CV_32F);
-
-        // 분자: Cf*Af + Cb*Ab*(1 - Af)
-        Fo = F.mul(af32) + B.mul(ab32.mul(1.0f - af32));
-
-        // 0으로 나눔 방지용 분모 클램프
-        Mat denom;
-        max(outA32, 1e-6, denom);
-
-        // 최종 컬러 = 분자 / 분모
-        Fo = Fo.mul(1.0f / denom);
-
-        // 8비트로 환원
-        Fo.convertTo(out[c], CV_8U);
-    }
-
-    // 최종 알파를 [0,255]로 환산
-    outA32.convertTo(out[3], CV_8U, 255.0);
-
-    merge(out, outRGBA);
-}
-
 /*
  * BGR 이미지 위에 RGBA를 불투명도(opacity) 조절하여 오버레이
  * - 입력: bgr(8UC3), rgba(8UC4)
@@ -261,7 +215,36 @@ int main(int argc, char **argv)
     double guideOpacity = 0.7; // 가이드 불투명도
     bool mirror = true;        // 미러링 여부
 
-    // 카메라 오픈: 우선순위 V4L2(0) -> V4L2(1) -> ANY
+#ifdef WITH_FRAMESOURCE
+    // 입력 오픈: Qt 앱과 같은 프레임 공급원 팩토리(카메라는 MJPG 640x480, 파일/이미지는 끝나면 반복)
+    const string sourceSpec = (argc >= 4) ? argv[3] : "v4l2:0";
+    std::unique_ptr<FrameSource> source = FrameSource::create(QString::fromStdString(sourceSpec));
+    if (!source)
+    {
+        fprintf(stderr, "unknown frame source: %s\n", sourceSpec.c_str());
+        return 2;
+    }
+    if (!source->open() && argc < 4)
+    { // 기본 카메라가 없으면 1번
+        std::unique_ptr<FrameSource> second = FrameSource::create("v4l2:1");
+        if (second && second->open())
+            source = std::move(second);
+    }
+    if (!source->isOpened())
+    {
+        fprintf(stderr, "source open fail: %s\n", qPrintable(source->describe()));
+        return 2;
+    }
+    fprintf(stderr, "[info] source: %s\n", qPrintable(source->describe()));
+    CapturedFrame slot;
+    auto grab = [&](Mat &out) {
+        if (!source->read(slot) || slot.bgr.empty())
+            return false;
+        out = slot.bgr; // 공급원 버퍼(미러는 복사본에)
+        return true;
+    };
+#else
+    // 입력 오픈: 카메라 0 → 1 → 기본 백엔드 순서로 시도
     VideoCapture cap(0, CAP_V4L2);
     if (!cap.isOpened())
         cap.open(1, CAP_V4L2);
@@ -277,21 +260,25 @@ int main(int argc, char **argv)
     cap.set(CAP_PROP_FOURCC, VideoWriter::fourcc('M', 'J', 'P', 'G'));
     cap.set(CAP_PROP_FRAME_WIDTH, 640);
     cap.set(CAP_PROP_FRAME_HEIGHT, 480);
+    auto grab = [&](Mat &out) { return cap.read(out) && !out.empty(); };
+#endif
 
     // 얼굴 검출기 로드(여러 경로 시도)
     CascadeClassifier faceDet;
     bool hasCascade = faceDet.load("/usr/share/opencv4/haarcascades/haarcascade_frontalface_default.xml") || faceDet.load("/usr/share/opencv/haarcascades/haarcascade_frontalface_default.xml") || faceDet.load("haarcascade_frontalface_default.xml");
 
-    Mat frame, view;
+    Mat raw, frame, view;
     for (;;)
     {
         // 프레임 획득 실패 시 종료
-        if (!cap.read(frame))
+        if (!grab(raw))
             break;
 
-        // 미러링 옵션
+        // 미러링 옵션(입력 버퍼는 그대로 두고 복사본에)
         if (mirror)
-            flip(frame, frame, 1);
+            flip(raw, frame, 1);
+        else
+            frame = raw;
 
         // 표시 크기로 리사이즈
         resize(frame, view, Size(W, H));
@@ -375,7 +362,7 @@ int main(int argc, char **argv)
 
             // 수트 ⊕ 얼굴 합성 (수트가 전경, 얼굴이 배경 역할)
             Mat out;
-            alphaOverRGBA(suitRGBA, faceRGBA, out);
+            alphaover::over(suitRGBA, faceRGBA, out);
 
             // 미리보기 표시
             Mat showBGR;